@@ -1,6 +1,21 @@
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <ctime>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include "record_export.h"
 using namespace std;
 
 // Base Class
@@ -27,6 +42,7 @@ public:
         : name(name), category(category), price(price), stock(stock) {}
 
     string getName() const { return name; }
+    string getCategory() const { return category; }
     double getPrice() const { return price; }
     int getStock() const { return stock; }
     void setStock(int s) { stock = s; }
@@ -59,10 +75,12 @@ private:
     int quantity;
 public:
     OrderItem(Product* p, int q) : product(p), quantity(q) {}
+    const Product* getProduct() const { return product; }
+    int getQuantity() const { return quantity; }
     double getTotal() const { return product->getPrice() * quantity; }
     void display() {
         cout << "- " << product->getName() << " x" << quantity
-             << " = $" << getTotal() << endl;
+             << " = $" << getTotal() << '\n';
     }
 };
 
@@ -93,11 +111,14 @@ public:
     }
 };
 
+class OrderHistoryStore;
+
 // Order class (aggregation of OrderItems)
 class Order {
 private:
     vector<OrderItem> items;
     string status;
+    uint32_t day = (uint32_t)(time(nullptr) / 86400); // days since 1970-01-01 (UTC)
 public:
     void addItem(Product* p, int qty) {
         items.push_back(OrderItem(p, qty));
@@ -110,22 +131,647 @@ public:
         return total;
     }
 
-    void processOrder(Payment* payment) {
-        double total = getTotalAmount();
-        payment->pay(total);
-        status = "Paid";
-    }
+    // Pays the order; paid orders are appended to the history store if one is given
+    void processOrder(Payment* payment, OrderHistoryStore* history = nullptr);
 
     void displayOrder() {
         cout << "Order Summary:\n";
         for (auto& item : items)
             item.display();
-        cout << "Total: $" << getTotalAmount() << ", Status: " << status << endl;
+        cout << "Total: $" << getTotalAmount() << ", Status: " << status << '\n';
     }
 
+    // Statement rows: one CSV line per item (ORDER_EXPORT_HEADER) or one JSON object per order
+    void appendRecord(exporter::RecordBuffer& out, exporter::Format format, uint64_t orderNumber) const;
+
     void setStatus(string s) { status = s; }
+    string getStatus() const { return status; }
+    const vector<OrderItem>& getItems() const { return items; }
+    uint32_t getDay() const { return day; }
+    void setDay(uint32_t d) { day = d; }
+};
+
+// Filter for history queries; rows outside it are skipped, and whole segments
+// are skipped using their zone maps before any column is read
+struct OrderQuery {
+    uint32_t fromDay = 0;
+    uint32_t toDay = UINT32_MAX;
+    int64_t categoryId = -1; // -1 = all categories
+};
+
+/**
+ * Append-only order history in compressed columnar segment files.
+ *
+ * Every order line is one row with columns order id, day, product, category,
+ * quantity and unit price (cents). Product and category names are dictionary
+ * encoded. Rows are buffered in memory and written as a segment of up to
+ * SEGMENT_ROWS rows: each column is delta + zigzag + varint encoded, so
+ * sorted columns (order id, day) shrink to about one byte per value.
+ *
+ * Each segment header holds a zone map (day range and a category bitmap).
+ * Queries skip segments the predicate excludes, read only the columns they
+ * need, and scan the remaining segments on all cores.
+ *
+ * The dictionary (length-prefixed names plus the next order id) is written
+ * before each segment, and both go through a temporary file and a rename, so
+ * a crash never leaves a segment that refers to names or ids the dictionary
+ * lacks. On open, segment headers are checked against the file size; a
+ * damaged file makes the store read-only for the valid prefix instead of
+ * being overwritten. Decoded ids are checked against the dictionary, and a
+ * segment that fails is skipped and counted in unreadableSegmentCount().
+ */
+class OrderHistoryStore {
+public:
+    enum Column { ORDER_ID, DAY, PRODUCT, CATEGORY, QUANTITY, PRICE, COLUMN_COUNT };
+
+private:
+    static const uint32_t SEGMENT_ROWS = 65536;
+    static const uint32_t MAX_VARINT_BYTES = 10;
+    static const uint32_t MAX_DAY = 2932896; // 9999-12-31; bounds the per-day sums of dailyTotals()
+
+    struct SegmentHeader {
+        char magic[8];
+        uint32_t rowCount;
+        uint32_t minDay, maxDay;
+        uint32_t reserved;
+        uint64_t categoryBits; // bit (category % 64) set if the category occurs
+        uint64_t columnOffset[COLUMN_COUNT];
+        uint64_t columnBytes[COLUMN_COUNT];
+    };
+
+    string directory;
+    vector<SegmentHeader> segments; // zone maps of every segment, kept in memory
+    vector<uint64_t> buffer[COLUMN_COUNT];
+    uint64_t nextOrderId = 0;
+    bool writable = true; // false once an existing file was found damaged
+    mutable atomic<uint64_t> unreadableSegments{0};
+
+    unordered_map<string, uint32_t> productIds, categoryIds;
+    vector<string> productNames, categoryNames;
+    uint32_t minDayAll = UINT32_MAX, maxDayAll = 0;
+
+    string segmentPath(size_t index) const {
+        return directory + "/segment_" + to_string(index) + ".col";
+    }
+
+    string dictionaryPath() const { return directory + "/dictionary.bin"; }
+
+    static uint32_t intern(unordered_map<string, uint32_t>& ids, vector<string>& names, const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        ids.emplace(name, (uint32_t)names.size());
+        names.push_back(name);
+        return (uint32_t)names.size() - 1;
+    }
+
+    static void putVarint(string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((char)value);
+    }
+
+    // The input must end with a byte below 0x80 (readColumns appends one), so
+    // a damaged varint stops there; overlong varints decode to garbage, not UB
+    static uint64_t getVarint(const uint8_t*& p) {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *p++;
+            value |= (uint64_t)(byte & 0x7f) << (shift & 63);
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    // Delta to the previous value, zigzag so small negative deltas stay small
+    static void encodeColumn(const vector<uint64_t>& values, string& out) {
+        uint64_t previous = 0;
+        for (uint64_t value : values) {
+            int64_t delta = (int64_t)(value - previous);
+            putVarint(out, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+            previous = value;
+        }
+    }
+
+    // False if the column bytes [p, end) hold fewer than rows values or a
+    // value lies outside [low, high]; *end must be the terminating byte
+    static bool decodeColumn(const uint8_t* p, const uint8_t* end, uint32_t rows, uint64_t low, uint64_t high,
+                             vector<uint64_t>& values) {
+        values.resize(rows);
+        uint64_t previous = 0, span = high - low, outside = 0;
+        for (uint32_t i = 0; i < rows; i++) {
+            if (p >= end) {
+                return false;
+            }
+            uint64_t zigzag = getVarint(p);
+            previous += (zigzag >> 1) ^ (0 - (zigzag & 1));
+            outside |= (uint64_t)(previous - low > span);
+            values[i] = previous;
+        }
+        return outside == 0 && p <= end;
+    }
+
+    // Writes bytes to a temporary file and renames it over path, so path
+    // always holds either the old or the complete new contents
+    static bool writeFileAtomically(const string& path, const string& bytes) {
+        string temporary = path + ".tmp";
+        FILE* file = fopen(temporary.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = fflush(file) == 0 && ok;
+        ok = fclose(file) == 0 && ok;
+        error_code error;
+        if (ok) {
+            filesystem::rename(temporary, path, error);
+        }
+        if (!ok || error) {
+            remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    static bool readWholeFile(const string& path, string& bytes) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        error_code error;
+        uint64_t size = filesystem::file_size(path, error);
+        bytes.resize(error ? 0 : (size_t)size);
+        bool ok = !error && fread(&bytes[0], 1, bytes.size(), file) == bytes.size();
+        fclose(file);
+        return ok;
+    }
+
+    template <typename T>
+    static void putRaw(string& out, T value) {
+        out.append((const char*)&value, sizeof(value));
+    }
+
+    template <typename T>
+    static bool getRaw(const string& in, size_t& pos, T& value) {
+        if (in.size() - pos < sizeof(value)) {
+            return false;
+        }
+        memcpy(&value, in.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+
+    // "ORDDIC01", next order id, name counts, then every name as length + bytes
+    string encodeDictionary() const {
+        string out("ORDDIC01", 8);
+        putRaw(out, nextOrderId);
+        putRaw(out, (uint32_t)productNames.size());
+        putRaw(out, (uint32_t)categoryNames.size());
+        for (const vector<string>* names : {&productNames, &categoryNames}) {
+            for (const auto& name : *names) {
+                putRaw(out, (uint32_t)name.size());
+                out += name;
+            }
+        }
+        return out;
+    }
+
+    bool decodeDictionary(const string& in, uint64_t& storedNextId) {
+        size_t pos = 8;
+        uint32_t counts[2];
+        if (in.size() < 8 || memcmp(in.data(), "ORDDIC01", 8) != 0 || !getRaw(in, pos, storedNextId) ||
+            !getRaw(in, pos, counts[0]) || !getRaw(in, pos, counts[1])) {
+            return false;
+        }
+        for (int kind = 0; kind < 2; kind++) {
+            for (uint32_t i = 0; i < counts[kind]; i++) {
+                uint32_t length;
+                if (!getRaw(in, pos, length) || in.size() - pos < length) {
+                    return false;
+                }
+                string name = in.substr(pos, length);
+                pos += length;
+                if (kind == 0) {
+                    intern(productIds, productNames, name);
+                } else {
+                    intern(categoryIds, categoryNames, name);
+                }
+            }
+        }
+        return productNames.size() == counts[0] && categoryNames.size() == counts[1] && pos == in.size();
+    }
+
+    // Every column must lie inside the file and hold one to MAX_VARINT_BYTES
+    // bytes per row, which also bounds rowCount by the file size
+    static bool headerFits(const SegmentHeader& header, uint64_t fileBytes) {
+        if (memcmp(header.magic, "ORDSEG01", 8) != 0 || header.rowCount == 0 || header.minDay > header.maxDay ||
+            header.maxDay > MAX_DAY) {
+            return false;
+        }
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            uint64_t offset = header.columnOffset[c], bytes = header.columnBytes[c];
+            if (offset < sizeof(header) || offset > fileBytes || bytes > fileBytes - offset ||
+                bytes < header.rowCount || bytes > (uint64_t)header.rowCount * MAX_VARINT_BYTES) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void markDamaged(const string& path) {
+        cout << "Order history file " << path << " is damaged; the store is read-only" << endl;
+        writable = false;
+    }
+
+    void loadExisting() {
+        string dictionary;
+        uint64_t storedNextId = 0;
+        bool hasDictionary = readWholeFile(dictionaryPath(), dictionary);
+        if (hasDictionary && !decodeDictionary(dictionary, storedNextId)) {
+            productIds.clear();
+            categoryIds.clear();
+            productNames.clear();
+            categoryNames.clear();
+            markDamaged(dictionaryPath());
+        }
+        // Segments are numbered 0, 1, 2, ...; stop at the first missing file
+        for (size_t i = 0;; i++) {
+            error_code error;
+            uint64_t fileBytes = filesystem::file_size(segmentPath(i), error);
+            if (error) {
+                break;
+            }
+            FILE* file = fopen(segmentPath(i).c_str(), "rb");
+            SegmentHeader header;
+            bool ok = file && fread(&header, sizeof(header), 1, file) == 1 && headerFits(header, fileBytes);
+            if (file) {
+                fclose(file);
+            }
+            if (!ok) {
+                markDamaged(segmentPath(i));
+                break;
+            }
+            segments.push_back(header);
+            minDayAll = min(minDayAll, header.minDay);
+            maxDayAll = max(maxDayAll, header.maxDay);
+        }
+        if (!segments.empty() && !hasDictionary) {
+            markDamaged(dictionaryPath());
+        }
+        // Order ids continue after the dictionary's counter, which is saved
+        // before every segment, and never below the last stored order
+        nextOrderId = storedNextId;
+        vector<uint64_t> columns[COLUMN_COUNT];
+        if (!segments.empty() && readColumns(segments.size() - 1, 1u << ORDER_ID, columns)) {
+            nextOrderId = max(nextOrderId, columns[ORDER_ID].back() + 1);
+        }
+    }
+
+    // Reads and decodes the columns in mask from segment index into columns[c]
+    bool readColumns(size_t index, uint32_t mask, vector<uint64_t>* columns) const {
+        const SegmentHeader& header = segments[index];
+        FILE* file = fopen(segmentPath(index).c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        vector<uint8_t> bytes;
+        bool ok = true;
+        for (int c = 0; c < COLUMN_COUNT && ok; c++) {
+            if (!(mask & (1u << c))) {
+                continue;
+            }
+            // Dictionary ids must name a known product/category and days must lie in
+            // the zone map, so aggregation can index its sums without bounds checks
+            uint64_t low = 0, high = UINT64_MAX;
+            if (c == PRODUCT || c == CATEGORY) {
+                size_t names = c == PRODUCT ? productNames.size() : categoryNames.size();
+                if (names == 0) {
+                    ok = false;
+                    break;
+                }
+                high = names - 1;
+            } else if (c == DAY) {
+                low = header.minDay;
+                high = header.maxDay;
+            }
+            size_t size = header.columnBytes[c];
+            bytes.resize(size + 1);
+            bytes[size] = 0; // terminator for getVarint
+            ok = fseek(file, (long)header.columnOffset[c], SEEK_SET) == 0 &&
+                 fread(bytes.data(), 1, size, file) == size &&
+                 decodeColumn(bytes.data(), bytes.data() + size, header.rowCount, low, high, columns[c]);
+        }
+        fclose(file);
+        return ok;
+    }
+
+    static bool segmentMatches(const SegmentHeader& header, const OrderQuery& query) {
+        if (header.maxDay < query.fromDay || header.minDay > query.toDay) {
+            return false;
+        }
+        return query.categoryId < 0 || (header.categoryBits >> (query.categoryId % 64) & 1);
+    }
+
+    // Adds qty * price of every matching row to sums[column value - keyBase]
+    static void accumulate(const vector<uint64_t>* columns, size_t rows, Column groupBy, const OrderQuery& query,
+                           uint64_t keyBase, vector<int64_t>& sums) {
+        const uint64_t* day = columns[DAY].data();
+        const uint64_t* category = columns[CATEGORY].data();
+        const uint64_t* quantity = columns[QUANTITY].data();
+        const uint64_t* price = columns[PRICE].data();
+        const uint64_t* key = columns[groupBy].data();
+        for (size_t i = 0; i < rows; i++) {
+            if (day[i] < query.fromDay || day[i] > query.toDay ||
+                (query.categoryId >= 0 && category[i] != (uint64_t)query.categoryId)) {
+                continue;
+            }
+            sums[key[i] - keyBase] += (int64_t)(quantity[i] * price[i]);
+        }
+    }
+
+    // Revenue in cents grouped by groupBy (PRODUCT, CATEGORY or DAY), over all segments and the buffer
+    vector<int64_t> aggregateRevenue(Column groupBy, const OrderQuery& query) const {
+        uint64_t keyBase = groupBy == DAY ? minDayAll : 0;
+        size_t keyCount = groupBy == DAY ? (maxDayAll >= minDayAll ? maxDayAll - minDayAll + 1 : 0)
+                        : groupBy == PRODUCT ? productNames.size() : categoryNames.size();
+        uint32_t mask = (1u << DAY) | (1u << CATEGORY) | (1u << QUANTITY) | (1u << PRICE) | (1u << groupBy);
+
+        // Zone maps decide which segments are read at all
+        vector<size_t> candidates;
+        for (size_t i = 0; i < segments.size(); i++) {
+            if (segmentMatches(segments[i], query)) {
+                candidates.push_back(i);
+            }
+        }
+
+        unsigned threadCount = max(1u, min<unsigned>(thread::hardware_concurrency(), (unsigned)candidates.size()));
+        vector<vector<int64_t>> partial(threadCount, vector<int64_t>(keyCount, 0));
+        atomic<size_t> next(0);
+        auto work = [&](unsigned t) {
+            vector<uint64_t> columns[COLUMN_COUNT];
+            for (size_t i; (i = next.fetch_add(1)) < candidates.size();) {
+                if (readColumns(candidates[i], mask, columns)) {
+                    accumulate(columns, segments[candidates[i]].rowCount, groupBy, query, keyBase, partial[t]);
+                } else {
+                    unreadableSegments.fetch_add(1, memory_order_relaxed);
+                }
+            }
+        };
+        vector<thread> workers;
+        for (unsigned t = 1; t < threadCount; t++) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        vector<int64_t> sums = move(partial[0]);
+        for (unsigned t = 1; t < threadCount; t++) {
+            for (size_t k = 0; k < keyCount; k++) {
+                sums[k] += partial[t][k];
+            }
+        }
+        accumulate(buffer, buffer[DAY].size(), groupBy, query, keyBase, sums);
+        return sums;
+    }
+
+public:
+    // Opens (or creates) a store in an existing directory
+    explicit OrderHistoryStore(const string& dir) : directory(dir) {
+        loadExisting();
+    }
+
+    ~OrderHistoryStore() { flush(); }
+
+    // Appends every line of the order; returns the assigned order id, or
+    // UINT64_MAX if the order's day is past MAX_DAY
+    uint64_t append(const Order& order) {
+        uint32_t day = order.getDay();
+        if (day > MAX_DAY) {
+            cout << "Order day " << day << " is out of range for the order history" << endl;
+            return UINT64_MAX;
+        }
+        uint64_t orderId = nextOrderId++;
+        for (const auto& item : order.getItems()) {
+            const Product* product = item.getProduct();
+            buffer[ORDER_ID].push_back(orderId);
+            buffer[DAY].push_back(day);
+            buffer[PRODUCT].push_back(intern(productIds, productNames, product->getName()));
+            buffer[CATEGORY].push_back(intern(categoryIds, categoryNames, product->getCategory()));
+            buffer[QUANTITY].push_back((uint64_t)item.getQuantity());
+            buffer[PRICE].push_back((uint64_t)llround(product->getPrice() * 100));
+        }
+        minDayAll = min(minDayAll, day);
+        maxDayAll = max(maxDayAll, day);
+        if (buffer[DAY].size() >= SEGMENT_ROWS) {
+            flush();
+        }
+        return orderId;
+    }
+
+    // Writes buffered rows as a new segment; on failure the rows stay buffered
+    bool flush() {
+        size_t rows = buffer[DAY].size();
+        if (rows == 0) {
+            return true;
+        }
+        if (!writable) {
+            cout << "Order history in " << directory << " is read-only; " << rows << " rows not written" << endl;
+            return false;
+        }
+        SegmentHeader header = {};
+        memcpy(header.magic, "ORDSEG01", 8);
+        header.rowCount = (uint32_t)rows;
+        header.minDay = (uint32_t)*min_element(buffer[DAY].begin(), buffer[DAY].end());
+        header.maxDay = (uint32_t)*max_element(buffer[DAY].begin(), buffer[DAY].end());
+        for (uint64_t category : buffer[CATEGORY]) {
+            header.categoryBits |= 1ULL << (category % 64);
+        }
+
+        string body;
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            header.columnOffset[c] = sizeof(header) + body.size();
+            encodeColumn(buffer[c], body);
+            header.columnBytes[c] = sizeof(header) + body.size() - header.columnOffset[c];
+        }
+        body.insert(0, (const char*)&header, sizeof(header));
+
+        // Dictionary first: a segment on disk never refers to a name or order id it lacks
+        if (!writeFileAtomically(dictionaryPath(), encodeDictionary()) ||
+            !writeFileAtomically(segmentPath(segments.size()), body)) {
+            cout << "Cannot write order history segment in " << directory << endl;
+            return false;
+        }
+        segments.push_back(header);
+        for (auto& column : buffer) {
+            column.clear();
+        }
+        return true;
+    }
+
+    int64_t findCategory(const string& name) const {
+        auto it = categoryIds.find(name);
+        return it == categoryIds.end() ? -2 : it->second; // -2 matches nothing
+    }
+
+    vector<pair<string, double>> revenueByCategory(const OrderQuery& query = OrderQuery()) const {
+        vector<int64_t> sums = aggregateRevenue(CATEGORY, query);
+        vector<pair<string, double>> result;
+        for (size_t c = 0; c < sums.size(); c++) {
+            if (sums[c] != 0) {
+                result.push_back({categoryNames[c], sums[c] / 100.0});
+            }
+        }
+        return result;
+    }
+
+    vector<pair<string, double>> topProducts(size_t n, const OrderQuery& query = OrderQuery()) const {
+        vector<int64_t> sums = aggregateRevenue(PRODUCT, query);
+        vector<uint32_t> order;
+        for (uint32_t p = 0; p < sums.size(); p++) {
+            if (sums[p] != 0) {
+                order.push_back(p);
+            }
+        }
+        n = min(n, order.size());
+        partial_sort(order.begin(), order.begin() + n, order.end(),
+                     [&sums](uint32_t a, uint32_t b) { return sums[a] > sums[b]; });
+        vector<pair<string, double>> result;
+        for (size_t i = 0; i < n; i++) {
+            result.push_back({productNames[order[i]], sums[order[i]] / 100.0});
+        }
+        return result;
+    }
+
+    // (day, revenue) for every day with sales, in day order
+    vector<pair<uint32_t, double>> dailyTotals(const OrderQuery& query = OrderQuery()) const {
+        vector<int64_t> sums = aggregateRevenue(DAY, query);
+        vector<pair<uint32_t, double>> result;
+        for (size_t d = 0; d < sums.size(); d++) {
+            if (sums[d] != 0) {
+                result.push_back({(uint32_t)(minDayAll + d), sums[d] / 100.0});
+            }
+        }
+        return result;
+    }
+
+    size_t segmentCount() const { return segments.size(); }
+
+    // Segments skipped by queries so far because they failed to read or validate
+    uint64_t unreadableSegmentCount() const { return unreadableSegments.load(memory_order_relaxed); }
+
+    uint64_t storedBytes() const {
+        uint64_t total = 0;
+        for (const auto& header : segments) {
+            total += header.columnOffset[COLUMN_COUNT - 1] + header.columnBytes[COLUMN_COUNT - 1];
+        }
+        return total;
+    }
 };
 
+void Order::processOrder(Payment* payment, OrderHistoryStore* history) {
+    double total = getTotalAmount();
+    payment->pay(total);
+    status = "Paid";
+    if (history) {
+        history->append(*this);
+    }
+}
+
+// Day number -> "YYYY-MM-DD"
+string formatDay(uint32_t day) {
+    time_t seconds = (time_t)day * 86400;
+    tm* utc = gmtime(&seconds);
+    char text[16];
+    strftime(text, sizeof(text), "%Y-%m-%d", utc);
+    return text;
+}
+
+// Day number -> YYYY-MM-DD without gmtime (not thread-safe) or strftime,
+// using the days-to-civil-date conversion from Howard Hinnant's date algorithms
+void appendDay(exporter::RecordBuffer& out, uint32_t day) {
+    int64_t z = (int64_t)day + 719468;
+    int64_t era = z / 146097;
+    uint32_t dayOfEra = (uint32_t)(z - era * 146097);
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    uint32_t mp = (5 * dayOfYear + 2) / 153;
+    uint32_t d = dayOfYear - (153 * mp + 2) / 5 + 1;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    int64_t y = (int64_t)yearOfEra + era * 400 + (m <= 2);
+    char text[10] = {(char)('0' + y / 1000 % 10), (char)('0' + y / 100 % 10), (char)('0' + y / 10 % 10),
+                     (char)('0' + y % 10), '-', (char)('0' + m / 10), (char)('0' + m % 10), '-',
+                     (char)('0' + d / 10), (char)('0' + d % 10)};
+    out.text(string_view(text, sizeof(text)));
+}
+
+void Order::appendRecord(exporter::RecordBuffer& out, exporter::Format format, uint64_t orderNumber) const {
+    if (format == exporter::Format::CSV) {
+        for (const auto& item : items) {
+            out.integer((int64_t)orderNumber);
+            out.put(',');
+            appendDay(out, day);
+            out.put(',');
+            out.field(item.getProduct()->getName(), format);
+            out.put(',');
+            out.field(item.getProduct()->getCategory(), format);
+            out.put(',');
+            out.integer(item.getQuantity());
+            out.put(',');
+            out.fixed(item.getProduct()->getPrice(), 2);
+            out.put(',');
+            out.fixed(item.getTotal(), 2);
+            out.put(',');
+            out.field(status, format);
+            out.put('\n');
+        }
+        return;
+    }
+    out.text("{\"order\":");
+    out.integer((int64_t)orderNumber);
+    out.text(",\"date\":\"");
+    appendDay(out, day);
+    out.text("\",\"status\":");
+    out.field(status, format);
+    out.text(",\"items\":[");
+    double total = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        const OrderItem& item = items[i];
+        out.text(i ? ",{\"product\":" : "{\"product\":");
+        out.field(item.getProduct()->getName(), format);
+        out.text(",\"category\":");
+        out.field(item.getProduct()->getCategory(), format);
+        out.text(",\"quantity\":");
+        out.integer(item.getQuantity());
+        out.text(",\"price\":");
+        out.fixed(item.getProduct()->getPrice(), 2);
+        out.put('}');
+        total += item.getTotal();
+    }
+    out.text("],\"total\":");
+    out.fixed(total, 2);
+    out.text("}\n");
+}
+
+const char* const ORDER_EXPORT_HEADER = "order,date,product,category,quantity,unit_price,line_total,status\n";
+
+// Writes customer statements as CSV or JSON Lines; orders are numbered from firstOrderNumber.
+// threads = 0 uses all cores
+bool exportOrders(const vector<Order>& orders, const string& path, exporter::Format format, unsigned threads = 1,
+                  uint64_t firstOrderNumber = 1, uint64_t* bytesWritten = nullptr) {
+    return exporter::writeFile(
+        path, orders, format == exporter::Format::CSV ? ORDER_EXPORT_HEADER : nullptr,
+        [format, firstOrderNumber](exporter::RecordBuffer& out, const Order& order, size_t index) {
+            order.appendRecord(out, format, firstOrderNumber + index);
+        },
+        threads, bytesWritten);
+}
+
 // Customer class
 class Customer : public User {
 private:
@@ -170,6 +816,76 @@ public:
     }
 };
 
+// Creates a new directory under the system temp directory; callers remove only this directory
+filesystem::path createTempDirectory(const string& prefix) {
+    random_device seed;
+    for (;;) {
+        uint32_t tag = seed() ^ (uint32_t)chrono::steady_clock::now().time_since_epoch().count();
+        filesystem::path dir = filesystem::temp_directory_path() / (prefix + "_" + to_string(tag));
+        if (filesystem::create_directory(dir)) {
+            return dir;
+        }
+    }
+}
+
+// Benchmark: monthly statements written the displayOrder way (ostream, endl) vs the exporter
+void benchmarkOrderExport() {
+    const uint32_t orderCount = 500000, productCount = 5000;
+    const filesystem::path dir = createTempDirectory("statement_bench");
+    const string ostreamPath = (dir / "ostream.csv").string(), exporterPath = (dir / "exporter.out").string();
+    vector<Product> products;
+    for (uint32_t p = 0; p < productCount; p++) {
+        products.emplace_back("Product" + to_string(p), "Category" + to_string(p % 20),
+                              1.0 + (p * 37 % 10000) / 100.0, 1000);
+    }
+    mt19937 rng(4);
+    vector<Order> orders(orderCount);
+    uint32_t firstDay = (uint32_t)(time(nullptr) / 86400) - 30;
+    for (uint32_t o = 0; o < orderCount; o++) {
+        orders[o].setDay(firstDay + o * 30 / orderCount);
+        orders[o].setStatus("Paid");
+        int items = 1 + rng() % 5;
+        for (int i = 0; i < items; i++) {
+            orders[o].addItem(&products[rng() % productCount], 1 + rng() % 3);
+        }
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    {
+        ofstream out(ostreamPath);
+        out << ORDER_EXPORT_HEADER;
+        for (uint32_t o = 0; o < orderCount; o++) {
+            for (const auto& item : orders[o].getItems()) {
+                out << o + 1 << ',' << formatDay(orders[o].getDay()) << ',' << item.getProduct()->getName() << ','
+                    << item.getProduct()->getCategory() << ',' << item.getQuantity() << ',' << fixed
+                    << setprecision(2) << item.getProduct()->getPrice() << ',' << item.getTotal() << ','
+                    << orders[o].getStatus() << endl;
+            }
+        }
+    }
+    double ostreamMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    uint64_t ostreamBytes = filesystem::file_size(ostreamPath);
+
+    cout << "method,ms,MB_per_s" << endl;
+    cout << "ostream + endl," << ostreamMs << "," << ostreamBytes / 1e3 / ostreamMs << endl;
+    struct Run {
+        const char* name;
+        exporter::Format format;
+        unsigned threads;
+    };
+    for (const Run& run : {Run{"exporter CSV", exporter::Format::CSV, 1},
+                           Run{"exporter CSV all cores", exporter::Format::CSV, 0},
+                           Run{"exporter JSON Lines", exporter::Format::JSON_LINES, 1},
+                           Run{"exporter JSON Lines all cores", exporter::Format::JSON_LINES, 0}}) {
+        uint64_t bytes = 0;
+        auto t1 = chrono::steady_clock::now();
+        bool ok = exportOrders(orders, exporterPath, run.format, run.threads, 1, &bytes);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t1).count();
+        cout << run.name << (ok ? "," : " (FAILED),") << ms << "," << bytes / 1e3 / ms << endl;
+    }
+    filesystem::remove_all(dir);
+}
+
 // Main function
 int main() {
     // Create Products
@@ -191,15 +907,40 @@ int main() {
     Order order = cust.createOrder();
     order.displayOrder();
 
-    // Payment
+    // Payment; the paid order is recorded in a scratch order history
+    const filesystem::path demoDir = createTempDirectory("order_history_demo");
+    filesystem::create_directory(demoDir / "history");
+    OrderHistoryStore history((demoDir / "history").string());
     EWalletPayment ewallet;
-    order.processOrder(&ewallet);
+    order.processOrder(&ewallet, &history);
 
     // Admin updates stock
     admin.manageProduct(p1, 8);
     admin.manageOrder(order, "Shipped");
 
     order.displayOrder();
+
+    // Analytics over the stored history
+    cout << "Revenue by category:\n";
+    for (const auto& entry : history.revenueByCategory()) {
+        cout << "- " << entry.first << ": $" << entry.second << endl;
+    }
+    for (const auto& entry : history.dailyTotals()) {
+        cout << "Total on " << formatDay(entry.first) << ": $" << entry.second << endl;
+    }
+    history.flush();
+
+    // Customer statement as JSON Lines
+    const string statementPath = (demoDir / "statement.jsonl").string();
+    exportOrders({order}, statementPath, exporter::Format::JSON_LINES);
+    ifstream statement(statementPath);
+    for (string line; getline(statement, line);) {
+        cout << line << endl;
+    }
+    statement.close();
+    filesystem::remove_all(demoDir);
+
+    benchmarkOrderExport();
     return 0;
 }
 
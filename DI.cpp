@@ -1,20 +1,36 @@
 #include <iostream>
+#include <tuple>
+#include <optional>
+#include <type_traits>
+#include <chrono>
 using namespace std;
 
 // Abstraksi tinta
 class Ink {
 public:
     virtual void use() = 0;
+    virtual ~Ink() = default;
 };
 
-// Tinta Hitam
-class BlackInk : public Ink {
+// Tinta Hitam (final: panggilan lewat BlackInk& bisa di-devirtualisasi)
+class BlackInk final : public Ink {
 public:
     void use() override {
         cout << "Menggunakan tinta hitam.\n";
     }
 };
 
+// Tinta yang hanya menghitung pemakaian, untuk benchmark tanpa output konsol
+class CountingInk final : public Ink {
+private:
+    volatile long long uses = 0; // volatile: loop benchmark tidak bisa dilipat compiler
+public:
+    void use() override {
+        uses = uses + 1;
+    }
+    long long getUses() const { return uses; }
+};
+
 // Printer menerima tinta dari luar
 class Printer {
 private:
@@ -26,13 +42,171 @@ public:
         cout << "Mulai mencetak... ";
         ink->use();
     }
+
+    void printSilent() {
+        ink->use();
+    }
 };
 
+// ===================== DI container compile-time =====================
+
+// Daftar dependency sebuah komponen, diisi dengan tipe key binding
+template <typename... Keys>
+struct DependsOn {};
+
+// Satu instance per container, dibuat saat pertama kali di-resolve
+template <typename Key, typename Impl = Key>
+struct Singleton {
+    using KeyType = Key;
+    using ImplType = Impl;
+    using Storage = optional<Impl>;
+    static constexpr bool isSingleton = true;
+};
+
+// Instance baru (by value) setiap kali di-resolve
+template <typename Key, typename Impl = Key>
+struct Transient {
+    using KeyType = Key;
+    using ImplType = Impl;
+    struct Storage {};
+    static constexpr bool isSingleton = false;
+};
+
+// Komponen tanpa "using Dependencies = DependsOn<...>" dianggap tanpa dependency
+template <typename T, typename = void>
+struct DependenciesOf {
+    using type = DependsOn<>;
+};
+
+template <typename T>
+struct DependenciesOf<T, void_t<typename T::Dependencies>> {
+    using type = typename T::Dependencies;
+};
+
+/**
+ * Container yang seluruh wiring-nya ditentukan saat compile.
+ *
+ * Binding dicari lewat template (bukan map runtime), singleton disimpan di
+ * dalam container (std::optional, tanpa heap), dan transient dikembalikan
+ * by value. Komponen menerima dependency sebagai tipe konkret, sehingga
+ * panggilan di hot path tidak perlu virtual. Binding yang hilang atau
+ * siklus dependency menjadi error compile, bukan error runtime.
+ */
+template <typename... Bindings>
+class Container {
+private:
+    using BindingList = tuple<Bindings...>;
+    tuple<typename Bindings::Storage...> storage;
+
+    template <typename Key, size_t I = 0>
+    static constexpr size_t indexOf() {
+        if constexpr (I >= sizeof...(Bindings)) {
+            static_assert(I < sizeof...(Bindings), "Tidak ada binding untuk tipe ini");
+            return I;
+        } else if constexpr (is_same_v<typename tuple_element_t<I, BindingList>::KeyType, Key>) {
+            return I;
+        } else {
+            return indexOf<Key, I + 1>();
+        }
+    }
+
+    template <typename Impl, typename... Keys>
+    Impl create(DependsOn<Keys...>) {
+        return Impl(resolve<Keys>()...);
+    }
+
+    template <typename Impl, typename... Keys>
+    void emplace(optional<Impl>& slot, DependsOn<Keys...>) {
+        slot.emplace(resolve<Keys>()...);
+    }
+
+public:
+    // Singleton: mengembalikan Impl&, transient: mengembalikan Impl
+    template <typename Key>
+    decltype(auto) resolve() {
+        constexpr size_t index = indexOf<Key>();
+        using Binding = tuple_element_t<index, BindingList>;
+        using Impl = typename Binding::ImplType;
+        if constexpr (Binding::isSingleton) {
+            auto& slot = get<index>(storage);
+            if (!slot) {
+                emplace(slot, typename DependenciesOf<Impl>::type{});
+            }
+            return (*slot);
+        } else {
+            return create<Impl>(typename DependenciesOf<Impl>::type{});
+        }
+    }
+};
+
+// Printer yang mengenal tipe tinta konkret; dependency-nya key Ink
+template <typename InkT>
+class TypedPrinter {
+private:
+    InkT& ink;
+public:
+    using Dependencies = DependsOn<Ink>;
+
+    explicit TypedPrinter(InkT& i) : ink(i) {}
+
+    void print() {
+        cout << "Mulai mencetak... ";
+        ink.use();
+    }
+
+    void printSilent() {
+        ink.use();
+    }
+};
+
+// Benchmark biaya resolve: wiring manual vs container vs Printer virtual
+void benchmarkResolve() {
+    const long long n = 100000000;
+    using Wiring = Container<Singleton<Ink, CountingInk>, Transient<TypedPrinter<CountingInk>>>;
+    Wiring container;
+    CountingInk manualInk, virtualInk;
+
+    auto t0 = chrono::steady_clock::now();
+    for (long long i = 0; i < n; i++) {
+        TypedPrinter<CountingInk> printer(manualInk);
+        printer.printSilent();
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (long long i = 0; i < n; i++) {
+        auto printer = container.resolve<TypedPrinter<CountingInk>>();
+        printer.printSilent();
+    }
+    auto t2 = chrono::steady_clock::now();
+    Ink* volatile opaque = &virtualInk; // cegah compiler menebak tipe tinta
+    for (long long i = 0; i < n; i++) {
+        Printer printer(opaque);
+        printer.printSilent();
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    auto ns = [n](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, nano>(b - a).count() / n;
+    };
+    cout << "metode,ns_per_resolve_dan_pakai" << endl;
+    cout << "wiring manual," << ns(t0, t1) << endl;
+    cout << "container," << ns(t1, t2) << endl;
+    cout << "Printer virtual," << ns(t2, t3) << endl;
+    if (manualInk.getUses() != container.resolve<Ink>().getUses() || virtualInk.getUses() != n) {
+        cout << "Jumlah pemakaian tinta tidak cocok!" << endl;
+    }
+}
+
 int main() {
     BlackInk black;
     Printer printer(&black); // Inject dependency
 
     printer.print(); // Output: Mulai mencetak... Menggunakan tinta hitam.
+
+    // Wiring yang sama lewat container
+    Container<Singleton<Ink, BlackInk>, Transient<TypedPrinter<BlackInk>>> container;
+    auto typedPrinter = container.resolve<TypedPrinter<BlackInk>>();
+    typedPrinter.print(); // Output: Mulai mencetak... Menggunakan tinta hitam.
+
+    benchmarkResolve();
     return 0;
 }
-
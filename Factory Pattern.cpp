@@ -1,10 +1,19 @@
 #include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
 using namespace std;
 
 // Abstraksi mobil
 class Car {
 public:
     virtual void drive() = 0;
+    virtual ~Car() = default;
 };
 
 class SportsCar : public Car {
@@ -21,20 +30,174 @@ public:
     }
 };
 
-// Factory
+// Id tipe mobil: hash FNV-1a dari nama, bisa dihitung saat compile
+using CarTypeId = uint32_t;
+
+constexpr CarTypeId carTypeId(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+// Pool slot berukuran tetap: objek dibuat di blok besar, slot yang dilepas
+// disimpan di free list (pointer next ditulis di dalam slot itu sendiri).
+// Tidak thread-safe; satu pool dipakai dari satu thread.
+class SlotPool {
+private:
+    static const size_t SLOTS_PER_BLOCK = 1024;
+    size_t slotSize;
+    vector<unique_ptr<max_align_t[]>> blocks;
+    void* freeList = nullptr;
+
+    void grow() {
+        size_t units = (slotSize * SLOTS_PER_BLOCK + sizeof(max_align_t) - 1) / sizeof(max_align_t);
+        blocks.emplace_back(new max_align_t[units]);
+        char* base = (char*)blocks.back().get();
+        for (size_t i = SLOTS_PER_BLOCK; i > 0; i--) {
+            void* slot = base + (i - 1) * slotSize;
+            *(void**)slot = freeList;
+            freeList = slot;
+        }
+    }
+
+public:
+    explicit SlotPool(size_t objectSize) {
+        size_t align = alignof(max_align_t);
+        size_t size = objectSize < sizeof(void*) ? sizeof(void*) : objectSize;
+        slotSize = (size + align - 1) / align * align;
+    }
+
+    void* allocate() {
+        if (freeList == nullptr) {
+            grow();
+        }
+        void* slot = freeList;
+        freeList = *(void**)slot;
+        return slot;
+    }
+
+    void release(void* slot) {
+        *(void**)slot = freeList;
+        freeList = slot;
+    }
+};
+
+// Deleter handle: memanggil destructor lalu mengembalikan slot ke pool asalnya.
+// Alamat slot disimpan sendiri karena Car* belum tentu sama dengan alamat awal
+// objek turunan (misalnya jika Car bukan base pertama pada multiple inheritance).
+struct PoolDeleter {
+    SlotPool* pool;
+    void* slot;
+    void operator()(Car* car) const {
+        car->~Car();
+        pool->release(slot);
+    }
+};
+
+// Handle pemilik mobil; otomatis kembali ke pool saat keluar scope
+using CarHandle = unique_ptr<Car, PoolDeleter>;
+
+// Factory berbasis registry: id tipe -> konstruktor + pool milik tipe tersebut
 class CarFactory {
+private:
+    struct Entry {
+        Car* (*construct)(void* memory);
+        unique_ptr<SlotPool> pool;
+    };
+
+    static unordered_map<CarTypeId, Entry>& registry() {
+        static unordered_map<CarTypeId, Entry> entries;
+        return entries;
+    }
+
 public:
-    static Car* createCar(string type) {
-        if (type == "sport") return new SportsCar();
-        else return new FamilyCar();
+    // Mendaftarkan tipe mobil baru; false jika id sudah dipakai
+    template <typename T>
+    static bool registerType(CarTypeId id) {
+        Entry entry{[](void* memory) -> Car* { return new (memory) T(); }, make_unique<SlotPool>(sizeof(T))};
+        return registry().emplace(id, std::move(entry)).second;
+    }
+
+    // Lookup O(1) dengan id; handle kosong jika tipe belum terdaftar
+    static CarHandle createCar(CarTypeId id) {
+        auto it = registry().find(id);
+        if (it == registry().end()) {
+            return CarHandle(nullptr, PoolDeleter{nullptr, nullptr});
+        }
+        SlotPool* pool = it->second.pool.get();
+        void* slot = pool->allocate();
+        return CarHandle(it->second.construct(slot), PoolDeleter{pool, slot});
+    }
+
+    // Versi nama; tipe yang tidak dikenal menjadi mobil keluarga seperti sebelumnya
+    static CarHandle createCar(const string& type) {
+        CarHandle car = createCar(carTypeId(type.c_str()));
+        return car ? std::move(car) : createCar(carTypeId("family"));
+    }
+};
+
+// Registrasi mandiri: cukup deklarasikan satu objek statis per tipe mobil.
+// Nama yang sudah terdaftar atau hash FNV yang bertabrakan menghentikan program
+// saat startup, agar tipe kedua tidak diam-diam tertutup tipe pertama.
+template <typename T>
+struct CarRegistrar {
+    explicit CarRegistrar(const char* name) {
+        if (!CarFactory::registerType<T>(carTypeId(name))) {
+            cerr << "Id tipe mobil \"" << name << "\" sudah dipakai tipe lain" << endl;
+            abort();
+        }
     }
 };
 
+static CarRegistrar<SportsCar> registerSportsCar("sport");
+static CarRegistrar<FamilyCar> registerFamilyCar("family");
+
+// Benchmark: new/delete per objek vs pool + registry
+void benchmarkFactory() {
+    const int rounds = 1000;
+    const int fleet = 10000; // jumlah kendaraan hidup bersamaan per putaran
+    const CarTypeId sport = carTypeId("sport");
+    const CarTypeId family = carTypeId("family");
+
+    auto start = chrono::steady_clock::now();
+    vector<Car*> raw(fleet);
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < fleet; i++) {
+            raw[i] = (i % 2) ? (Car*)new SportsCar() : (Car*)new FamilyCar();
+        }
+        for (Car* car : raw) {
+            delete car;
+        }
+    }
+    auto middle = chrono::steady_clock::now();
+    vector<CarHandle> pooled;
+    pooled.reserve(fleet);
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < fleet; i++) {
+            pooled.push_back(CarFactory::createCar((i % 2) ? sport : family));
+        }
+        pooled.clear();
+    }
+    auto end = chrono::steady_clock::now();
+
+    double total = (double)rounds * fleet;
+    cout << "metode,ns_per_buat_dan_hapus" << endl;
+    cout << "new/delete," << chrono::duration<double, nano>(middle - start).count() / total << endl;
+    cout << "pool registry," << chrono::duration<double, nano>(end - middle).count() / total << endl;
+}
+
 int main() {
-    Car* myCar = CarFactory::createCar("sport");
+    CarHandle myCar = CarFactory::createCar("sport");
     myCar->drive(); // Output: Mengemudi mobil sport!
 
-    delete myCar;
+    // Id tipe bisa dihitung saat compile, tanpa perbandingan string
+    constexpr CarTypeId family = carTypeId("family");
+    CarHandle familyCar = CarFactory::createCar(family);
+    familyCar->drive(); // Output: Mengemudi mobil keluarga.
+
+    // Tidak perlu delete: handle mengembalikan objek ke pool
+    benchmarkFactory();
     return 0;
 }
-
@@ -1,28 +1,58 @@
 #include <iostream>
+#include <vector>
+#include <variant>
+#include <chrono>
+#include <cstddef>
 using namespace std;
 
 // Abstraksi strategi
 class Strategy {
 public:
     virtual int calculate(int a, int b) = 0;
-};
 
-// Strategi penjumlahan
-class Add : public Strategy {
-public:
-    int calculate(int a, int b) override {
-        return a + b;
+    // Versi batch: out[i] = calculate(a[i], b[i]) untuk seluruh array.
+    // Satu panggilan virtual per batch, bukan per pasangan operand.
+    virtual void calculateBatch(const int* a, const int* b, int* out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = calculate(a[i], b[i]);
+        }
     }
+
+    virtual ~Strategy() = default;
 };
 
-// Strategi pengurangan
-class Subtract : public Strategy {
+// Operasi dasar sebagai functor non-virtual agar bisa di-inline compiler
+struct AddOp {
+    int operator()(int a, int b) const { return a + b; }
+};
+
+struct SubtractOp {
+    int operator()(int a, int b) const { return a - b; }
+};
+
+// Strategi yang dibangun dari functor: loop batch-nya tanpa panggilan
+// virtual sehingga bisa di-inline dan di-vektorisasi (SIMD) oleh compiler
+template <typename Op>
+class OpStrategy : public Strategy {
 public:
     int calculate(int a, int b) override {
-        return a - b;
+        return Op()(a, b);
+    }
+
+    void calculateBatch(const int* a, const int* b, int* out, size_t n) override {
+        Op op;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = op(a[i], b[i]);
+        }
     }
 };
 
+// Strategi penjumlahan
+class Add : public OpStrategy<AddOp> {};
+
+// Strategi pengurangan
+class Subtract : public OpStrategy<SubtractOp> {};
+
 // Kalkulator menggunakan strategi
 class Calculator {
 private:
@@ -33,8 +63,109 @@ public:
     int execute(int a, int b) {
         return strategy->calculate(a, b);
     }
+
+    // Menerapkan strategi ke seluruh array operand sekaligus.
+    // false (out dikosongkan) jika panjang a dan b berbeda
+    bool executeBatch(const vector<int>& a, const vector<int>& b, vector<int>& out) {
+        if (a.size() != b.size()) {
+            out.clear();
+            return false;
+        }
+        out.resize(a.size());
+        strategy->calculateBatch(a.data(), b.data(), out.data(), a.size());
+        return true;
+    }
 };
 
+// Jalur cepat untuk strategi yang diketahui saat compile: tanpa virtual sama sekali
+template <typename Op>
+class StaticCalculator {
+public:
+    int execute(int a, int b) const {
+        return Op()(a, b);
+    }
+
+    // false (out dikosongkan) jika panjang a dan b berbeda
+    bool executeBatch(const vector<int>& a, const vector<int>& b, vector<int>& out) const {
+        if (a.size() != b.size()) {
+            out.clear();
+            return false;
+        }
+        out.resize(a.size());
+        Op op;
+        for (size_t i = 0; i < a.size(); i++) {
+            out[i] = op(a[i], b[i]);
+        }
+        return true;
+    }
+};
+
+// Jalur cepat untuk strategi yang dipilih saat runtime dari himpunan tertutup:
+// std::visit dilakukan sekali per batch, loop di dalamnya tetap ter-inline
+using AnyOp = variant<AddOp, SubtractOp>;
+
+// false (out dikosongkan) jika panjang a dan b berbeda
+bool executeBatch(const AnyOp& op, const vector<int>& a, const vector<int>& b, vector<int>& out) {
+    if (a.size() != b.size()) {
+        out.clear();
+        return false;
+    }
+    out.resize(a.size());
+    visit([&](auto concrete) {
+        for (size_t i = 0; i < a.size(); i++) {
+            out[i] = concrete(a[i], b[i]);
+        }
+    }, op);
+    return true;
+}
+
+// Benchmark: virtual per elemen vs batch virtual vs template vs variant.
+// strategy dan op harus mewakili operasi yang sama dengan Op.
+template <typename Op>
+void benchmarkStrategies(Strategy* strategy, const AnyOp& op) {
+    const size_t n = 10000000;
+    const int rounds = 10;
+    vector<int> a(n), b(n), out(n);
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (int)(i * 7 % 1000);
+        b[i] = (int)(i * 13 % 1000);
+    }
+
+    Calculator calc(strategy);
+    StaticCalculator<Op> staticCalc;
+    long long checksum[4] = {0, 0, 0, 0};
+    double nsPerOp[4];
+
+    for (int mode = 0; mode < 4; mode++) {
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            if (mode == 0) {
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = calc.execute(a[i], b[i]);
+                }
+            } else if (mode == 1) {
+                calc.executeBatch(a, b, out);
+            } else if (mode == 2) {
+                staticCalc.executeBatch(a, b, out);
+            } else {
+                executeBatch(op, a, b, out);
+            }
+            checksum[mode] += out[r];
+        }
+        auto end = chrono::steady_clock::now();
+        nsPerOp[mode] = chrono::duration<double, nano>(end - start).count() / (double)(n * rounds);
+    }
+
+    const char* names[] = {"virtual per elemen", "batch virtual", "template", "variant"};
+    cout << "metode,ns_per_operasi" << endl;
+    for (int mode = 0; mode < 4; mode++) {
+        cout << names[mode] << "," << nsPerOp[mode] << endl;
+    }
+    if (checksum[0] != checksum[1] || checksum[1] != checksum[2] || checksum[2] != checksum[3]) {
+        cout << "Hasil tidak cocok!" << endl;
+    }
+}
+
 int main() {
     Add add;
     Subtract subtract;
@@ -45,6 +176,24 @@ int main() {
     Calculator calc2(&subtract);
     cout << "Hasil pengurangan: " << calc2.execute(5, 3) << endl; // 2
 
+    vector<int> a = {1, 2, 3, 4}, b = {10, 20, 30, 40}, out;
+    calc1.executeBatch(a, b, out);
+    cout << "Hasil penjumlahan batch:";
+    for (int x : out) {
+        cout << " " << x;
+    }
+    cout << endl;
+
+    vector<int> shorter = {1, 2};
+    cout << "Batch dengan panjang berbeda ditolak: " << (calc1.executeBatch(a, shorter, out) ? "tidak" : "ya") << endl;
+
+    StaticCalculator<SubtractOp> fast;
+    cout << "Hasil pengurangan (template): " << fast.execute(5, 3) << endl; // 2
+
+    // Pointer lewat volatile agar compiler tidak bisa men-devirtualisasi
+    // panggilan per elemen, seperti strategi yang dipilih saat runtime
+    Strategy* volatile opaque = &add;
+    benchmarkStrategies<AddOp>(opaque, AnyOp(AddOp()));
+
     return 0;
 }
-
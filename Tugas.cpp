@@ -2,6 +2,21 @@
 #include <string>
 #include <ctime>
 #include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "instrumentation.h"
+#include "record_export.h"
  
 using namespace std;
 
@@ -42,12 +57,48 @@ public:
     virtual bool processPayment() = 0; // pure virtual method
     virtual bool refundPayment() = 0; // pure virtual method
 
+    // Nama metode dan referensi tujuan (kartu tersamar, rekening, id dompet) untuk laporan
+    virtual const char* getMethodName() const = 0;
+    virtual void appendReference(exporter::RecordBuffer& out, exporter::Format format) const = 0;
+
     // Method untuk menampilkan informasi pembayaran
     virtual void displayInfo() const {
-        std::cout << "ID Pembayaran: " << id << std::endl;
-        std::cout << "Jumlah: Rp " << std::fixed << std::setprecision(2) << amount << std::endl;
-        std::cout << "Tanggal: " << date << std::endl;
-        std::cout << "Status: " << status << std::endl;
+        std::cout << "ID Pembayaran: " << id << '\n';
+        std::cout << "Jumlah: Rp " << std::fixed << std::setprecision(2) << amount << '\n';
+        std::cout << "Tanggal: " << date << '\n';
+        std::cout << "Status: " << status << '\n';
+    }
+
+    // Satu baris laporan: CSV (kolom PAYMENT_EXPORT_HEADER) atau satu objek JSON
+    void appendRecord(exporter::RecordBuffer& out, exporter::Format format) const {
+        if (format == exporter::Format::CSV) {
+            out.field(id, format);
+            out.put(',');
+            out.fixed(amount, 2);
+            out.put(',');
+            out.field(date, format);
+            out.put(',');
+            out.field(status, format);
+            out.put(',');
+            out.text(getMethodName());
+            out.put(',');
+            appendReference(out, format);
+        } else {
+            out.text("{\"id\":");
+            out.field(id, format);
+            out.text(",\"amount\":");
+            out.fixed(amount, 2);
+            out.text(",\"date\":");
+            out.field(date, format);
+            out.text(",\"status\":");
+            out.field(status, format);
+            out.text(",\"method\":\"");
+            out.text(getMethodName());
+            out.text("\",\"reference\":");
+            appendReference(out, format);
+            out.put('}');
+        }
+        out.put('\n');
     }
 
     // Destructor virtual
@@ -71,52 +122,57 @@ public:
         // Validasi kartu kredit
         // Contoh: cek apakah format kartu valid
         if (cardNumber.length() != 16) {
-            std::cout << "Validasi gagal: Nomor kartu kredit harus 16 digit." << std::endl;
+            std::cout << "Validasi gagal: Nomor kartu kredit harus 16 digit." << '\n';
             return false;
         }
 
         // Cek format tanggal kadaluarsa (MM/YY)
         if (expiryDate.length() != 5 || expiryDate[2] != '/') {
-            std::cout << "Validasi gagal: Format tanggal kadaluarsa harus MM/YY." << std::endl;
+            std::cout << "Validasi gagal: Format tanggal kadaluarsa harus MM/YY." << '\n';
             return false;
         }
 
         // Cek CVV
         if (cvv.length() != 3) {
-            std::cout << "Validasi gagal: CVV harus 3 digit." << std::endl;
+            std::cout << "Validasi gagal: CVV harus 3 digit." << '\n';
             return false;
         }
 
-        std::cout << "Validasi kartu kredit berhasil." << std::endl;
+        std::cout << "Validasi kartu kredit berhasil." << '\n';
         return true;
     }
 
     // Implementasi method processPayment
     bool processPayment() override {
+        TRACE_SCOPE("payment.process.creditcard");
         if (validatePayment()) {
             // Proses pembayaran kartu kredit
-            std::cout << "Memproses pembayaran kartu kredit untuk ID: " << getId() << std::endl;
-            std::cout << "Menghubungi gateway pembayaran..." << std::endl;
+            std::cout << "Memproses pembayaran kartu kredit untuk ID: " << getId() << '\n';
+            std::cout << "Menghubungi gateway pembayaran..." << '\n';
             // Simulasi proses pembayaran
             setStatus("COMPLETED");
-            std::cout << "Pembayaran kartu kredit berhasil." << std::endl;
+            std::cout << "Pembayaran kartu kredit berhasil." << '\n';
+            TRACE_COUNT("payment.completed");
             return true;
         }
         setStatus("FAILED");
+        TRACE_COUNT("payment.failed");
         return false;
     }
 
     // Implementasi method refundPayment
     bool refundPayment() override {
+        TRACE_SCOPE("payment.refund.creditcard");
         if (getStatus() == "COMPLETED") {
             std::cout << "Memproses pengembalian dana ke kartu kredit dengan nomor: "
-                      << maskCardNumber() << std::endl;
+                      << maskCardNumber() << '\n';
             // Simulasi proses refund
             setStatus("REFUNDED");
-            std::cout << "Pengembalian dana berhasil." << std::endl;
+            std::cout << "Pengembalian dana berhasil." << '\n';
             return true;
         } else {
-            std::cout << "Pengembalian dana gagal: Pembayaran harus berstatus COMPLETED" << std::endl;
+            std::cout << "Pengembalian dana gagal: Pembayaran harus berstatus COMPLETED" << '\n';
+            TRACE_COUNT("payment.refund_rejected");
             return false;
         }
     }
@@ -132,12 +188,24 @@ public:
         return masked + cardNumber.substr(cardNumber.length() - 4);
     }
 
+    const char* getMethodName() const override { return "CREDIT_CARD"; }
+
+    // Nomor kartu tersamar tanpa membuat string baru
+    void appendReference(exporter::RecordBuffer& out, exporter::Format format) const override {
+        char masked[32];
+        size_t length = std::min(cardNumber.length(), sizeof(masked));
+        size_t hidden = cardNumber.length() < 4 ? 0 : length - std::min<size_t>(4, length);
+        std::memset(masked, '*', hidden);
+        std::memcpy(masked + hidden, cardNumber.data() + cardNumber.length() - (length - hidden), length - hidden);
+        out.field(std::string_view(masked, length), format);
+    }
+
     // Override method displayInfo
     void displayInfo() const override {
         Payment::displayInfo();
-        std::cout << "Metode: Kartu Kredit" << std::endl;
-        std::cout << "Nomor Kartu: " << maskCardNumber() << std::endl;
-        std::cout << "Tanggal Kadaluarsa: " << expiryDate << std::endl;
+        std::cout << "Metode: Kartu Kredit" << '\n';
+        std::cout << "Nomor Kartu: " << maskCardNumber() << '\n';
+        std::cout << "Tanggal Kadaluarsa: " << expiryDate << '\n';
     }
 };
 
@@ -158,57 +226,68 @@ public:
         // Validasi transfer bank
         // Cek apakah nomor rekening valid
         if (accountNumber.length() < 8) {
-            std::cout << "Validasi gagal: Nomor rekening terlalu pendek." << std::endl;
+            std::cout << "Validasi gagal: Nomor rekening terlalu pendek." << '\n';
             return false;
         }
 
         // Cek kode transfer
         if (transferCode.empty()) {
-            std::cout << "Validasi gagal: Kode transfer tidak boleh kosong." << std::endl;
+            std::cout << "Validasi gagal: Kode transfer tidak boleh kosong." << '\n';
             return false;
         }
 
-        std::cout << "Validasi transfer bank berhasil." << std::endl;
+        std::cout << "Validasi transfer bank berhasil." << '\n';
         return true;
     }
 
     // Implementasi method processPayment
     bool processPayment() override {
+        TRACE_SCOPE("payment.process.bank");
         if (validatePayment()) {
             // Proses transfer bank
-            std::cout << "Memproses transfer bank untuk ID: " << getId() << std::endl;
-            std::cout << "Menghubungi bank " << bankName << "..." << std::endl;
+            std::cout << "Memproses transfer bank untuk ID: " << getId() << '\n';
+            std::cout << "Menghubungi bank " << bankName << "..." << '\n';
             // Simulasi proses pembayaran
             setStatus("COMPLETED");
-            std::cout << "Transfer bank berhasil." << std::endl;
+            std::cout << "Transfer bank berhasil." << '\n';
+            TRACE_COUNT("payment.completed");
             return true;
         }
         setStatus("FAILED");
+        TRACE_COUNT("payment.failed");
         return false;
     }
 
     // Implementasi method refundPayment
     bool refundPayment() override {
+        TRACE_SCOPE("payment.refund.bank");
         if (getStatus() == "COMPLETED") {
             std::cout << "Memproses pengembalian dana ke rekening bank " << bankName
-                      << " dengan nomor: " << accountNumber << std::endl;
+                      << " dengan nomor: " << accountNumber << '\n';
             // Simulasi proses refund
             setStatus("REFUNDED");
-            std::cout << "Pengembalian dana berhasil." << std::endl;
+            std::cout << "Pengembalian dana berhasil." << '\n';
             return true;
         } else {
-            std::cout << "Pengembalian dana gagal: Pembayaran harus berstatus COMPLETED" << std::endl;
+            std::cout << "Pengembalian dana gagal: Pembayaran harus berstatus COMPLETED" << '\n';
+            TRACE_COUNT("payment.refund_rejected");
             return false;
         }
     }
 
+    const char* getMethodName() const override { return "BANK_TRANSFER"; }
+
+    void appendReference(exporter::RecordBuffer& out, exporter::Format format) const override {
+        out.field(accountNumber, format);
+    }
+
     // Override method displayInfo
     void displayInfo() const override {
         Payment::displayInfo();
-        std::cout << "Metode: Transfer Bank" << std::endl;
-        std::cout << "Nomor Rekening: " << accountNumber << std::endl;
-        std::cout << "Nama Bank: " << bankName << std::endl;
-        std::cout << "Kode Transfer: " << transferCode << std::endl;
+        std::cout << "Metode: Transfer Bank" << '\n';
+        std::cout << "Nomor Rekening: " << accountNumber << '\n';
+        std::cout << "Nama Bank: " << bankName << '\n';
+        std::cout << "Kode Transfer: " << transferCode << '\n';
     }
 };
 
@@ -228,68 +307,1320 @@ public:
     bool validatePayment() override {
         // Validasi dompet digital
         if (walletId.empty()) {
-            std::cout << "Validasi gagal: ID dompet tidak boleh kosong." << std::endl;
+            std::cout << "Validasi gagal: ID dompet tidak boleh kosong." << '\n';
             return false;
         }
 
         // Cek provider
         if (provider.empty()) {
-            std::cout << "Validasi gagal: Provider tidak boleh kosong." << std::endl;
+            std::cout << "Validasi gagal: Provider tidak boleh kosong." << '\n';
             return false;
         }
 
         // Cek nomor telepon
         if (phoneNumber.length() < 10) {
-            std::cout << "Validasi gagal: Nomor telepon tidak valid." << std::endl;
+            std::cout << "Validasi gagal: Nomor telepon tidak valid." << '\n';
             return false;
         }
 
-        std::cout << "Validasi dompet digital berhasil." << std::endl;
+        std::cout << "Validasi dompet digital berhasil." << '\n';
         return true;
     }
 
     // Implementasi method processPayment
     bool processPayment() override {
+        TRACE_SCOPE("payment.process.wallet");
         if (validatePayment()) {
             // Proses pembayaran dompet digital
-            std::cout << "Memproses pembayaran dompet digital untuk ID: " << getId() << std::endl;
-            std::cout << "Menghubungi provider " << provider << "..." << std::endl;
+            std::cout << "Memproses pembayaran dompet digital untuk ID: " << getId() << '\n';
+            std::cout << "Menghubungi provider " << provider << "..." << '\n';
             // Simulasi proses pembayaran
             setStatus("COMPLETED");
-            std::cout << "Pembayaran dompet digital berhasil." << std::endl;
+            std::cout << "Pembayaran dompet digital berhasil." << '\n';
+            TRACE_COUNT("payment.completed");
             return true;
         }
         setStatus("FAILED");
+        TRACE_COUNT("payment.failed");
         return false;
     }
 
     // Implementasi method refundPayment
     bool refundPayment() override {
+        TRACE_SCOPE("payment.refund.wallet");
         if (getStatus() == "COMPLETED") {
             std::cout << "Memproses pengembalian dana ke dompet digital " << provider
-                      << " dengan ID: " << walletId << std::endl;
+                      << " dengan ID: " << walletId << '\n';
             // Simulasi proses refund
             setStatus("REFUNDED");
-            std::cout << "Pengembalian dana berhasil." << std::endl;
+            std::cout << "Pengembalian dana berhasil." << '\n';
             return true;
         } else {
-            std::cout << "Pengembalian dana gagal: Pembayaran harus berstatus COMPLETED" << std::endl;
+            std::cout << "Pengembalian dana gagal: Pembayaran harus berstatus COMPLETED" << '\n';
+            TRACE_COUNT("payment.refund_rejected");
             return false;
         }
     }
 
+    const char* getMethodName() const override { return "DIGITAL_WALLET"; }
+
+    void appendReference(exporter::RecordBuffer& out, exporter::Format format) const override {
+        out.field(walletId, format);
+    }
+
     // Override method displayInfo
     void displayInfo() const override {
         Payment::displayInfo();
-        std::cout << "Metode: Dompet Digital" << std::endl;
-        std::cout << "Provider: " << provider << std::endl;
-        std::cout << "ID Dompet: " << walletId << std::endl;
-        std::cout << "Nomor Telepon: " << phoneNumber << std::endl;
+        std::cout << "Metode: Dompet Digital" << '\n';
+        std::cout << "Provider: " << provider << '\n';
+        std::cout << "ID Dompet: " << walletId << '\n';
+        std::cout << "Nomor Telepon: " << phoneNumber << '\n';
     }
 };
 
+// ===================== Idempotency pembayaran =====================
+
+/**
+ * Tabel hash berukuran tetap berisi id pembayaran yang baru saja dilihat.
+ *
+ * Setiap slot menyimpan hash 64-bit id (untuk memilih grup dan menyaring
+ * cepat) dan id itu sendiri, jadi dua id berbeda dengan hash sama tetap
+ * dibedakan. Id sampai INLINE_ID_BYTES byte disimpan langsung di slot; untuk
+ * id yang lebih panjang slot menyimpan fingerprint 128-bit (MurmurHash64A
+ * dengan dua seed), sehingga bersama hash 64-bit id dibedakan dengan 192 bit.
+ * Tabel dibagi menjadi grup 7 slot seukuran dua cache line. Setiap id punya
+ * dua grup kandidat (dari bagian hash yang berbeda). Grup pertama
+ * diutamakan; grup kedua dipakai jika grup pertama hampir penuh dan grup
+ * kedua lebih longgar. Sebagian besar pencarian cukup membaca satu grup, dan
+ * kedua grup jarang penuh bersamaan walaupun tabel terisi lebih dari
+ * setengah.
+ *
+ * Pencarian tidak mengambil lock dan tidak pernah menunggu penulis. Setiap
+ * slot punya versi sendiri (ganjil berarti identitas slot sedang ditulis
+ * ulang). Pembaca hanya memeriksa versi slot yang hash-nya cocok; jika slot
+ * itu sedang atau baru saja ditulis, lookup() langsung mengembalikan BUSY
+ * alih-alih mengulang. Slot lain yang sedang ditulis tidak memengaruhi
+ * pembaca. complete() hanya mengganti satu word meta, jadi tidak membuat
+ * pembaca BUSY. Penulisan saling mengunci kedua grup kandidat saja, selalu
+ * dengan urutan alamat agar tidak deadlock.
+ *
+ * Entri kedaluwarsa setelah ttl. Slot kedaluwarsa dipakai ulang; jika kedua
+ * grup penuh, entri selesai yang paling cepat kedaluwarsa yang diganti. Entri
+ * yang masih IN_PROGRESS tidak pernah diganti sebelum kedaluwarsa.
+ */
+class IdempotencyCache {
+public:
+    // Status entri; GROUP_FULL hanya nilai kembalian claim() dan BUSY hanya
+    // nilai kembalian lookup(), keduanya tidak disimpan
+    enum State : uint64_t { EMPTY = 0, IN_PROGRESS = 1, SUCCEEDED = 2, FAILED = 3, GROUP_FULL = 4, BUSY = 5 };
+
+    static constexpr size_t INLINE_ID_BYTES = 24;
+
+private:
+    static const int SLOTS = 7;
+    static constexpr int ID_WORDS = INLINE_ID_BYTES / 8;
+    static constexpr uint64_t LONG_ID = 63; // penanda panjang di meta untuk id yang disimpan sebagai fingerprint
+
+    // writeLock + 7 key = 64 byte (cache line pertama), meta di cache line
+    // kedua. meta = (waktu kedaluwarsa dalam ms << 8) | (panjang id << 2) | state,
+    // 0 berarti kosong. writeLock hanya dipakai antar penulis.
+    struct alignas(64) Group {
+        std::atomic<uint64_t> writeLock;
+        std::atomic<uint64_t> keys[SLOTS];
+        std::atomic<uint64_t> metas[SLOTS];
+    };
+
+    // Versi dan byte id (atau fingerprint) milik satu slot
+    struct SlotId {
+        std::atomic<uint64_t> version;
+        std::atomic<uint64_t> words[ID_WORDS];
+    };
+
+    std::unique_ptr<Group[]> groups;
+    std::unique_ptr<SlotId[]> ids; // indeks grup * SLOTS + slot
+    uint64_t groupMask;
+    uint64_t ttlMs;
+    std::atomic<uint64_t> evictions{0};
+
+    size_t firstGroup(uint64_t key) const { return key & groupMask; }
+    size_t secondGroup(uint64_t key) const { return (key >> 32) & groupMask; }
+
+    static uint64_t makeMeta(uint64_t expiry, uint64_t length, uint64_t state) {
+        return (expiry << 8) | (length << 2) | state;
+    }
+    static uint64_t expiryOf(uint64_t meta) { return meta >> 8; }
+    static uint64_t lengthOf(uint64_t meta) { return (meta >> 2) & 63; }
+    static State stateOf(uint64_t meta) { return State(meta & 3); }
+
+    static uint64_t lengthField(std::string_view id) {
+        return id.size() <= INLINE_ID_BYTES ? id.size() : LONG_ID;
+    }
+
+    // MurmurHash64A; dua seed berbeda membentuk fingerprint 128-bit id panjang
+    static uint64_t murmur64(std::string_view id, uint64_t seed) {
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        uint64_t h = seed ^ (id.size() * m);
+        size_t i = 0;
+        for (; i + 8 <= id.size(); i += 8) {
+            uint64_t k;
+            std::memcpy(&k, id.data() + i, 8);
+            k *= m;
+            k ^= k >> 47;
+            k *= m;
+            h = (h ^ k) * m;
+        }
+        if (i < id.size()) {
+            uint64_t k = 0;
+            std::memcpy(&k, id.data() + i, id.size() - i);
+            h = (h ^ k) * m;
+        }
+        h ^= h >> 47;
+        h *= m;
+        h ^= h >> 47;
+        return h;
+    }
+
+    static void packId(std::string_view id, uint64_t (&words)[ID_WORDS]) {
+        std::memset(words, 0, sizeof(words));
+        if (id.size() <= INLINE_ID_BYTES) {
+            std::memcpy(words, id.data(), id.size());
+        } else {
+            words[0] = murmur64(id, 0x8445d61a4e774912ULL);
+            words[1] = murmur64(id, 0x2b992ddfa23249d6ULL);
+        }
+    }
+
+    static void lockGroup(Group& g) {
+        while (g.writeLock.exchange(1, std::memory_order_acquire) != 0) {
+            while (g.writeLock.load(std::memory_order_relaxed) != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    static void unlockGroup(Group& g) { g.writeLock.store(0, std::memory_order_release); }
+
+    // Mengunci kedua grup kandidat (sekali saja jika sama), urut alamat
+    void lockPair(Group& a, Group& b) {
+        Group* first = &a < &b ? &a : &b;
+        Group* second = &a < &b ? &b : &a;
+        lockGroup(*first);
+        if (second != first) {
+            lockGroup(*second);
+        }
+    }
+
+    void unlockPair(Group& a, Group& b) {
+        unlockGroup(a);
+        if (&b != &a) {
+            unlockGroup(b);
+        }
+    }
+
+    // Membandingkan id slot dengan id dicari
+    bool slotHoldsId(size_t slotIndex, uint64_t meta, std::string_view id, const uint64_t (&words)[ID_WORDS]) const {
+        if (lengthOf(meta) != lengthField(id)) {
+            return false;
+        }
+        for (int w = 0; w < ID_WORDS; w++) {
+            if (ids[slotIndex].words[w].load(std::memory_order_relaxed) != words[w]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Mencari id di satu grup tanpa menunggu penulis. FOUND mengisi meta;
+    // SLOT_BUSY berarti slot dengan hash id sedang atau baru saja ditulis ulang.
+    enum Probe { MISSING, FOUND, SLOT_BUSY };
+
+    Probe findInGroup(size_t groupIndex, uint64_t key, std::string_view id, const uint64_t (&words)[ID_WORDS],
+                      uint64_t& meta) const {
+        const Group& g = groups[groupIndex];
+        Probe result = MISSING;
+        for (int s = 0; s < SLOTS; s++) {
+            if (g.keys[s].load(std::memory_order_relaxed) != key) {
+                continue;
+            }
+            const SlotId& slot = ids[groupIndex * SLOTS + s];
+            uint64_t before = slot.version.load(std::memory_order_acquire);
+            if (before & 1) {
+                result = SLOT_BUSY;
+                continue;
+            }
+            bool keyStill = g.keys[s].load(std::memory_order_relaxed) == key;
+            uint64_t m = g.metas[s].load(std::memory_order_relaxed);
+            bool same = keyStill && m != 0 && slotHoldsId(groupIndex * SLOTS + s, m, id, words);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) != before) {
+                result = SLOT_BUSY;
+            } else if (same) {
+                meta = m;
+                return FOUND;
+            }
+        }
+        return result;
+    }
+
+    // Mengisi slot untuk id; pemanggil memegang lock grup slot itu
+    void storeSlot(size_t groupIndex, int slot, uint64_t key, const uint64_t (&words)[ID_WORDS], uint64_t meta) {
+        Group& g = groups[groupIndex];
+        SlotId& record = ids[groupIndex * SLOTS + slot];
+        uint64_t version = record.version.load(std::memory_order_relaxed);
+        record.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int w = 0; w < ID_WORDS; w++) {
+            record.words[w].store(words[w], std::memory_order_relaxed);
+        }
+        g.keys[slot].store(key, std::memory_order_relaxed);
+        g.metas[slot].store(meta, std::memory_order_relaxed);
+        record.version.store(version + 2, std::memory_order_release);
+    }
+
+public:
+    // maxKeys: perkiraan jumlah id yang hidup bersamaan dalam satu ttl
+    IdempotencyCache(size_t maxKeys, uint64_t ttl) : ttlMs(ttl) {
+        size_t groupCount = 2;
+        while (groupCount * SLOTS * 3 / 4 < maxKeys) {
+            groupCount <<= 1;
+        }
+        groups.reset(new Group[groupCount]);
+        ids.reset(new SlotId[groupCount * SLOTS]);
+        for (size_t i = 0; i < groupCount; i++) {
+            groups[i].writeLock.store(0, std::memory_order_relaxed);
+            for (int s = 0; s < SLOTS; s++) {
+                groups[i].keys[s].store(0, std::memory_order_relaxed);
+                groups[i].metas[s].store(0, std::memory_order_relaxed);
+                ids[i * SLOTS + s].version.store(0, std::memory_order_relaxed);
+                for (int w = 0; w < ID_WORDS; w++) {
+                    ids[i * SLOTS + s].words[w].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+        groupMask = groupCount - 1;
+    }
+
+    // Hash FNV-1a + finalizer agar bit rendah (indeks grup) teracak rata
+    static uint64_t hashKey(std::string_view id) {
+        return hashKey(id.data(), id.size());
+    }
+
+    static uint64_t hashKey(const char* id, size_t length) {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; i++) {
+            h = (h ^ (unsigned char)id[i]) * 1099511628211ULL;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h ? h : 1; // 0 dipakai sebagai penanda slot kosong
+    }
+
+    static uint64_t nowMs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Status id pada waktu now (EMPTY jika tidak ada atau sudah kedaluwarsa,
+    // BUSY jika slot id sedang ditulis ulang; pemanggil boleh mengulang).
+    // key = hashKey(id), boleh dihitung sekali oleh pemanggil.
+    State lookup(std::string_view id, uint64_t key, uint64_t now) const {
+        uint64_t words[ID_WORDS];
+        packId(id, words);
+        uint64_t meta = 0;
+        Probe first = findInGroup(firstGroup(key), key, id, words, meta);
+        Probe second = first == FOUND ? FOUND : findInGroup(secondGroup(key), key, id, words, meta);
+        if (first == FOUND || second == FOUND) {
+            return expiryOf(meta) > now ? stateOf(meta) : EMPTY;
+        }
+        return first == SLOT_BUSY || second == SLOT_BUSY ? BUSY : EMPTY;
+    }
+
+    State lookup(std::string_view id, uint64_t now) const { return lookup(id, hashKey(id), now); }
+
+    /**
+     * @brief Mengklaim id untuk diproses
+     *
+     * @return EMPTY jika pemanggil berhasil mengklaim (wajib memanggil complete()),
+     *         status entri yang ada jika id sudah dikenal, atau GROUP_FULL jika
+     *         semua slot kandidat sedang diproses
+     */
+    State claim(std::string_view id, uint64_t key, uint64_t now) {
+        State existing = lookup(id, key, now);
+        if (existing != EMPTY && existing != BUSY) {
+            return existing; // Jalur cepat duplikat; BUSY diputuskan ulang di bawah lock
+        }
+
+        uint64_t words[ID_WORDS];
+        packId(id, words);
+        size_t indexes[2] = {firstGroup(key), secondGroup(key)};
+        Group& a = groups[indexes[0]];
+        Group& b = groups[indexes[1]];
+        lockPair(a, b);
+
+        // Cari ulang di bawah lock; sekaligus catat slot kosong dan kandidat eviction
+        int target = -1, slot = -1, freeCount[2] = {0, 0}, freeSlot[2] = {-1, -1};
+        int victimGroup = -1, victim = -1;
+        uint64_t victimExpiry = UINT64_MAX;
+        for (int c = 0; c < (&a == &b ? 1 : 2) && target < 0; c++) {
+            Group& g = groups[indexes[c]];
+            for (int s = 0; s < SLOTS; s++) {
+                uint64_t meta = g.metas[s].load(std::memory_order_relaxed);
+                uint64_t expiry = expiryOf(meta);
+                if (meta != 0 && g.keys[s].load(std::memory_order_relaxed) == key &&
+                    slotHoldsId(indexes[c] * SLOTS + s, meta, id, words)) {
+                    if (expiry > now) {
+                        unlockPair(a, b); // Diklaim thread lain sejak lookup
+                        return stateOf(meta);
+                    }
+                    target = c; // Entri lama id yang sama, pakai ulang slotnya
+                    slot = s;
+                    break;
+                }
+                if (meta == 0 || expiry <= now) {
+                    if (freeSlot[c] < 0) {
+                        freeSlot[c] = s;
+                    }
+                    freeCount[c]++;
+                } else if (stateOf(meta) != IN_PROGRESS && expiry < victimExpiry) {
+                    victimGroup = c;
+                    victim = s;
+                    victimExpiry = expiry;
+                }
+            }
+        }
+
+        if (target < 0) {
+            if (freeCount[0] > 0 || freeCount[1] > 0) {
+                // Grup kedua dipakai hanya jika grup pertama hampir penuh dan grup kedua lebih longgar
+                target = (freeCount[0] >= 2 || freeCount[0] >= freeCount[1]) ? 0 : 1;
+                slot = freeSlot[target];
+            } else if (victim >= 0) {
+                target = victimGroup;
+                slot = victim;
+                evictions.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                unlockPair(a, b);
+                return GROUP_FULL;
+            }
+        }
+        storeSlot(indexes[target], slot, key, words, makeMeta(now + ttlMs, lengthField(id), IN_PROGRESS));
+        unlockPair(a, b);
+        return EMPTY;
+    }
+
+    State claim(std::string_view id, uint64_t now) { return claim(id, hashKey(id), now); }
+
+    // Menyimpan hasil pemrosesan id yang sudah diklaim; ttl dihitung ulang dari now
+    void complete(std::string_view id, uint64_t key, bool success, uint64_t now) {
+        uint64_t words[ID_WORDS];
+        packId(id, words);
+        size_t indexes[2] = {firstGroup(key), secondGroup(key)};
+        Group& a = groups[indexes[0]];
+        Group& b = groups[indexes[1]];
+        lockPair(a, b);
+        for (size_t groupIndex : indexes) {
+            Group& g = groups[groupIndex];
+            for (int s = 0; s < SLOTS; s++) {
+                uint64_t meta = g.metas[s].load(std::memory_order_relaxed);
+                if (meta != 0 && g.keys[s].load(std::memory_order_relaxed) == key &&
+                    slotHoldsId(groupIndex * SLOTS + s, meta, id, words)) {
+                    // Identitas slot tetap, jadi cukup satu store tanpa menaikkan versi
+                    g.metas[s].store(makeMeta(now + ttlMs, lengthOf(meta), success ? SUCCEEDED : FAILED),
+                                     std::memory_order_release);
+                    unlockPair(a, b);
+                    return;
+                }
+            }
+        }
+        unlockPair(a, b);
+    }
+
+    void complete(std::string_view id, bool success, uint64_t now) { complete(id, hashKey(id), success, now); }
+
+    uint64_t getEvictions() const { return evictions.load(std::memory_order_relaxed); }
+    size_t memoryBytes() const { return (groupMask + 1) * (sizeof(Group) + SLOTS * sizeof(SlotId)); }
+};
+
+// Lapisan idempotency di depan processPayment(): id yang sama tidak diproses dua kali
+class IdempotentPaymentGateway {
+public:
+    enum SubmitStatus {
+        PROCESSED,   // Id baru, processPayment() dijalankan
+        DUPLICATE,   // Id sudah selesai diproses, hasil tersimpan dikembalikan
+        IN_PROGRESS, // Id yang sama sedang diproses thread lain
+        OVERLOADED   // Grup tabel penuh dengan pembayaran yang sedang diproses
+    };
+
+private:
+    IdempotencyCache cache;
+
+public:
+    IdempotentPaymentGateway(size_t maxKeys, uint64_t ttlMs) : cache(maxKeys, ttlMs) {}
+
+    /**
+     * @brief Memproses pembayaran sekali per id selama ttl
+     *
+     * @return Hasil processPayment(), atau hasil yang tersimpan untuk duplikat.
+     *         IN_PROGRESS dan OVERLOADED mengembalikan false; klien boleh mencoba lagi.
+     */
+    bool submit(Payment& payment, SubmitStatus* status = nullptr) {
+        const std::string& id = payment.getId();
+        uint64_t key = IdempotencyCache::hashKey(id);
+        IdempotencyCache::State state = cache.claim(id, key, IdempotencyCache::nowMs());
+        SubmitStatus result;
+        bool success = false;
+        if (state == IdempotencyCache::EMPTY) {
+            success = payment.processPayment();
+            cache.complete(id, key, success, IdempotencyCache::nowMs());
+            result = PROCESSED;
+        } else if (state == IdempotencyCache::IN_PROGRESS) {
+            result = IN_PROGRESS;
+        } else if (state == IdempotencyCache::GROUP_FULL) {
+            result = OVERLOADED;
+        } else {
+            TRACE_COUNT("payment.duplicate");
+            success = state == IdempotencyCache::SUCCEEDED;
+            result = DUPLICATE;
+        }
+        if (status) {
+            *status = result;
+        }
+        return success;
+    }
+
+    const IdempotencyCache& getCache() const { return cache; }
+};
+
+// Benchmark tabel idempotency dengan jutaan id
+void benchmarkIdempotency() {
+    const size_t keyCount = 4000000;
+    const size_t lookups = 10000000;
+    IdempotencyCache cache(keyCount, 60 * 60 * 1000);
+
+    std::vector<std::string> ids(keyCount);
+    std::vector<uint64_t> keys(keyCount);
+    for (size_t i = 0; i < keyCount; i++) {
+        ids[i] = "PAY" + std::to_string(i);
+        keys[i] = IdempotencyCache::hashKey(ids[i]);
+    }
+
+    uint64_t now = IdempotencyCache::nowMs();
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keyCount; i++) {
+        cache.claim(ids[i], keys[i], now);
+        cache.complete(ids[i], keys[i], i % 10 != 0, now);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::mt19937_64 rng(5);
+    std::vector<uint32_t> order(lookups);
+    for (auto& index : order) {
+        index = (uint32_t)(rng() % keyCount);
+    }
+    size_t duplicates = 0;
+    auto t2 = std::chrono::steady_clock::now();
+    for (uint32_t index : order) {
+        duplicates += cache.claim(ids[index], keys[index], now) != IdempotencyCache::EMPTY;
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    // Jalur lengkap dengan hash string id
+    std::string id = "PAY1234567";
+    auto t4 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        id[3 + i % 7] = (char)('0' + i % 10);
+        duplicates += cache.lookup(id, now) != IdempotencyCache::EMPTY;
+    }
+    auto t5 = std::chrono::steady_clock::now();
+
+    auto ns = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b, size_t n) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / n;
+    };
+    std::cout << "operasi,ns_per_operasi" << std::endl;
+    std::cout << "claim+complete id baru," << ns(t0, t1, keyCount) << std::endl;
+    std::cout << "claim id duplikat," << ns(t2, t3, lookups) << std::endl;
+    std::cout << "hash+lookup dari string," << ns(t4, t5, lookups) << std::endl;
+    std::cout << "Duplikat terdeteksi: " << duplicates << ", eviction: " << cache.getEvictions()
+              << ", memori: " << cache.memoryBytes() / (1024 * 1024) << " MB" << std::endl;
+}
+
+// ===================== Rekonsiliasi settlement =====================
+
+// Hasil rekonsiliasi catatan pembayaran terhadap file settlement bank/provider
+struct ReconciliationSummary {
+    uint64_t matched = 0;             // Id dan jumlah sama di kedua sisi
+    uint64_t amountMismatch = 0;      // Id ada di kedua sisi, jumlah berbeda
+    uint64_t missingInSettlement = 0; // Ada di catatan kita, tidak ada di settlement
+    uint64_t missingInRecords = 0;    // Ada di settlement, tidak ada di catatan kita
+    uint64_t malformedLines = 0;      // Baris yang tidak bisa dibaca (misalnya header)
+    uint32_t partitions = 0;
+    uint32_t repartitions = 0;        // Partisi yang dipecah ulang karena melebihi batas memori
+};
+
+// Pembaca baris dengan buffer besar; baris dikembalikan sebagai pointer ke buffer
+class LineReader {
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t begin = 0, end = 0;
+    bool eof = false;
+
+public:
+    explicit LineReader(std::FILE* f, size_t bufferSize = 1 << 20) : file(f), buffer(bufferSize) {}
+
+    // Baris berikutnya tanpa '\n' dan '\r'; valid sampai next() dipanggil lagi
+    bool next(const char*& line, size_t& length) {
+        while (true) {
+            char* newline = (char*)std::memchr(buffer.data() + begin, '\n', end - begin);
+            if (newline || (eof && begin < end)) {
+                size_t stop = newline ? (size_t)(newline - buffer.data()) : end;
+                line = buffer.data() + begin;
+                length = stop - begin;
+                begin = newline ? stop + 1 : end;
+                if (length > 0 && line[length - 1] == '\r') {
+                    length--;
+                }
+                return true;
+            }
+            if (eof) {
+                return false;
+            }
+            // Geser sisa baris ke depan, perbesar buffer jika satu baris tidak muat
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+            if (end == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            }
+            size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, file);
+            end += got;
+            eof = got == 0;
+        }
+    }
+};
+
+/**
+ * Rekonsiliasi catatan pembayaran (CSV "id,jumlah") terhadap file settlement
+ * (format sama) dengan partitioned hash join.
+ *
+ * Fase 1: kedua file dibaca berurutan dan setiap baris ditulis ke file
+ * partisi sesuai hash id (format biner: panjang id, id, jumlah dalam sen).
+ * Sisi build adalah file yang lebih kecil; sisi probe yang lain.
+ * Fase 2: partisi di-join paralel; setiap worker memuat sisi build satu
+ * partisi ke hash table flat lalu mengalirkan sisi probe partisi yang sama
+ * per chunk READ_CHUNK byte.
+ *
+ * Batas memori dibagi rata ke worker dan mencakup buffer baca, buffer spill
+ * dan buffer output, bukan hanya hash table. Jumlah partisi awal dihitung
+ * dari ukuran sisi build, batas memori dan ukuran cache, dibatasi
+ * MAX_PARTITIONS file terbuka. Partisi yang tetap terlalu besar (file sangat
+ * besar atau hash tidak rata) dipecah ulang dengan seed hash lain, sampai
+ * MAX_DEPTH tingkat. Partisi yang masih terlalu besar setelah itu (misalnya
+ * satu id yang berulang jutaan kali) di-join per blok sebesar batas memori:
+ * record probe yang belum berpasangan ditulis ke file sisa untuk blok
+ * berikutnya. Jumlah dibandingkan dalam sen (integer), bukan double.
+ *
+ * Output: <prefix>_matched.csv, <prefix>_mismatch.csv (id,kita,settlement)
+ * dan <prefix>_missing.csv (id,sisi,jumlah). Setiap kegagalan baca/tulis
+ * membuat run() mengembalikan false; file partisi sementara selalu dihapus.
+ */
+class ReconciliationEngine {
+private:
+    std::string spillDirectory;
+    size_t memoryBudget;
+    unsigned threadCount;
+
+    static constexpr uint32_t MAX_PARTITIONS = 512; // batas file terbuka bersamaan per pemecahan
+    static constexpr uint32_t MAX_DEPTH = 3;        // tingkat pemecahan ulang partisi
+    static constexpr size_t FLUSH_BYTES = 1 << 20;
+    static constexpr size_t SPILL_BUFFER = 64 << 10;
+    static constexpr size_t READ_CHUNK = 256 << 10;
+    static constexpr size_t MIN_RECORD_BYTES = 2 + 1 + 8; // panjang id + id 1 byte + sen
+    static constexpr uint64_t CACHE_TARGET = 4 << 20;   // ukuran tabel per partisi yang diincar
+
+    // Penulis file partisi dengan buffer sendiri; kegagalan tulis diingat
+    class SpillWriter {
+    private:
+        std::FILE* file = nullptr;
+        std::string buffer;
+        bool ok = true;
+    public:
+        SpillWriter() = default;
+        SpillWriter(SpillWriter&& other) noexcept : file(other.file), buffer(std::move(other.buffer)), ok(other.ok) {
+            other.file = nullptr;
+        }
+        ~SpillWriter() { close(); }
+
+        bool open(const std::string& path) {
+            file = std::fopen(path.c_str(), "wb");
+            return file != nullptr;
+        }
+        void append(const char* id, uint16_t length, int64_t cents) {
+            buffer.append((const char*)&length, sizeof(length));
+            buffer.append(id, length);
+            buffer.append((const char*)&cents, sizeof(cents));
+            if (buffer.size() >= SPILL_BUFFER) {
+                flush();
+            }
+        }
+        bool flush() {
+            if (ok && !buffer.empty()) {
+                ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+            }
+            buffer.clear();
+            return ok;
+        }
+        // true jika semua data tertulis dan file tertutup dengan benar
+        bool close() {
+            if (!file) {
+                return ok;
+            }
+            flush();
+            ok = std::fclose(file) == 0 && ok;
+            file = nullptr;
+            return ok;
+        }
+    };
+
+    // Pembaca file partisi per chunk; record tidak pernah lebih dari satu chunk
+    class PartitionReader {
+    private:
+        std::FILE* file = nullptr;
+        std::vector<char> buffer;
+        size_t begin = 0, end = 0;
+        bool eof = false, failed = false;
+    public:
+        PartitionReader() : buffer(READ_CHUNK) {}
+        ~PartitionReader() {
+            if (file) {
+                std::fclose(file);
+            }
+        }
+
+        bool open(const std::string& path) {
+            file = std::fopen(path.c_str(), "rb");
+            failed = file == nullptr;
+            return !failed;
+        }
+
+        // false di akhir file atau saat gagal; bedakan dengan failed()
+        bool next(const char*& id, uint16_t& length, int64_t& cents) {
+            while (true) {
+                size_t available = end - begin;
+                if (available >= sizeof(length)) {
+                    std::memcpy(&length, buffer.data() + begin, sizeof(length));
+                    size_t recordBytes = sizeof(length) + length + sizeof(cents);
+                    if (available >= recordBytes) {
+                        id = buffer.data() + begin + sizeof(length);
+                        std::memcpy(&cents, id + length, sizeof(cents));
+                        begin += recordBytes;
+                        return true;
+                    }
+                }
+                if (eof || failed) {
+                    failed = failed || available > 0; // record terpotong
+                    return false;
+                }
+                std::memmove(buffer.data(), buffer.data() + begin, available);
+                end = available;
+                begin = 0;
+                size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, file);
+                end += got;
+                eof = got == 0;
+                failed = std::ferror(file) != 0;
+            }
+        }
+
+        bool ok() const { return !failed; }
+    };
+
+    // Output bersama; setiap worker mengumpulkan di buffer lokal lalu flush sekaligus
+    struct SharedOutput {
+        std::FILE* file = nullptr;
+        std::mutex lock;
+        bool ok = true;
+        void write(std::string& local, bool force) {
+            if (local.size() >= FLUSH_BYTES || (force && !local.empty())) {
+                std::lock_guard<std::mutex> guard(lock);
+                ok = ok && std::fwrite(local.data(), 1, local.size(), file) == local.size();
+                local.clear();
+            }
+        }
+        bool close() {
+            ok = file && std::fclose(file) == 0 && ok;
+            file = nullptr;
+            return ok;
+        }
+    };
+
+    // Parameter fase 2 yang sama untuk semua worker
+    struct JoinPlan {
+        bool buildIsRecords;  // true: sisi build = catatan kita
+        size_t tableLimit;    // byte hash table + arena per worker
+        uint32_t fanout;      // partisi per pemecahan ulang
+        SharedOutput* outputs;
+    };
+
+    // Output satu worker: buffer lokal dan hitungan
+    struct JoinSink {
+        const JoinPlan& plan;
+        ReconciliationSummary& summary;
+        std::string matched, mismatch, missing;
+
+        void pair(const char* id, uint16_t length, int64_t buildCents, int64_t probeCents) {
+            int64_t ours = plan.buildIsRecords ? buildCents : probeCents;
+            int64_t theirs = plan.buildIsRecords ? probeCents : buildCents;
+            if (ours == theirs) {
+                summary.matched++;
+                matched.append(id, length).push_back(',');
+                appendCents(matched, ours);
+                matched.push_back('\n');
+                plan.outputs[0].write(matched, false);
+            } else {
+                summary.amountMismatch++;
+                mismatch.append(id, length).push_back(',');
+                appendCents(mismatch, ours);
+                mismatch.push_back(',');
+                appendCents(mismatch, theirs);
+                mismatch.push_back('\n');
+                plan.outputs[1].write(mismatch, false);
+            }
+        }
+
+        void unmatched(const char* id, uint16_t length, int64_t cents, bool fromBuild) {
+            bool inRecords = fromBuild == plan.buildIsRecords;
+            (inRecords ? summary.missingInSettlement : summary.missingInRecords)++;
+            missing.append(id, length).append(inRecords ? ",records," : ",settlement,");
+            appendCents(missing, cents);
+            missing.push_back('\n');
+            plan.outputs[2].write(missing, false);
+        }
+
+        void flush() {
+            plan.outputs[0].write(matched, true);
+            plan.outputs[1].write(mismatch, true);
+            plan.outputs[2].write(missing, true);
+        }
+    };
+
+    // side: 'b' (build), 'p' (probe) atau 'q' (sisa probe); name: "3", "3_17", ...
+    std::string partitionPath(char side, const std::string& name) const {
+        return spillDirectory + "/recon_" + side + "_" + name + ".bin";
+    }
+
+    static uint64_t fileSize(const std::string& path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        return in ? (uint64_t)in.tellg() : 0;
+    }
+
+    // Partisi id untuk seed tertentu; setiap tingkat pemecahan memakai seed lain
+    static uint32_t partitionOf(const char* id, uint16_t length, uint32_t seed, uint32_t partitions) {
+        uint64_t h = IdempotencyCache::hashKey(id, length) ^ (seed * 0x9e3779b97f4a7c15ULL);
+        h ^= h >> 31;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 29;
+        return (uint32_t)((h >> 32) % partitions);
+    }
+
+    // Record per blok: slot (tabel pangkat dua, terisi paling banyak setengah)
+    // memakai separuh tableLimit, arena id separuh sisanya
+    static size_t blockRecords(size_t tableLimit) {
+        return std::max<size_t>(tableLimit / 2 / (4 * sizeof(BuildTable::Slot)), 1);
+    }
+
+    // true jika file partisi sebesar bytes pasti muat dalam satu blok
+    static bool fitsInTable(uint64_t bytes, size_t tableLimit) {
+        return bytes / MIN_RECORD_BYTES + 1 <= blockRecords(tableLimit) && bytes <= tableLimit / 2;
+    }
+
+    // "1500000", "1500000.5" atau "-20.75" -> sen
+    static bool parseCents(const char* p, const char* end, int64_t& cents) {
+        bool negative = p < end && *p == '-';
+        if (negative) {
+            p++;
+        }
+        if (p == end) {
+            return false;
+        }
+        int64_t value = 0;
+        int decimals = -1;
+        for (; p < end; p++) {
+            if (*p == '.' && decimals < 0) {
+                decimals = 0;
+            } else if (*p >= '0' && *p <= '9' && decimals < 2) {
+                value = value * 10 + (*p - '0');
+                if (decimals >= 0) {
+                    decimals++;
+                }
+            } else if (!(*p >= '0' && *p <= '9')) {
+                return false; // digit desimal ketiga dst. diabaikan
+            }
+        }
+        for (int d = decimals < 0 ? 0 : decimals; d < 2; d++) {
+            value *= 10;
+        }
+        cents = negative ? -value : value;
+        return true;
+    }
+
+    // Sen -> "123.45" tanpa snprintf (dipanggil sekali per baris output)
+    static void appendCents(std::string& out, int64_t cents) {
+        char text[24];
+        char* end = text + sizeof(text);
+        char* p = end;
+        uint64_t magnitude = cents < 0 ? 0 - (uint64_t)cents : (uint64_t)cents;
+        *--p = (char)('0' + magnitude % 10);
+        *--p = (char)('0' + magnitude / 10 % 10);
+        *--p = '.';
+        magnitude /= 100;
+        do {
+            *--p = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (cents < 0) {
+            *--p = '-';
+        }
+        out.append(p, end - p);
+    }
+
+    // Membuka penulis untuk partisi <prefix>0 .. <prefix>(count-1)
+    bool openWriters(std::vector<SpillWriter>& writers, char side, const std::string& prefix, uint32_t count) const {
+        writers.resize(count);
+        for (uint32_t p = 0; p < count; p++) {
+            if (!writers[p].open(partitionPath(side, prefix + std::to_string(p)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool closeWriters(std::vector<SpillWriter>& writers) {
+        bool ok = true;
+        for (auto& writer : writers) {
+            ok = writer.close() && ok;
+        }
+        return ok;
+    }
+
+    // Fase 1: satu file CSV -> partitions file partisi
+    bool partitionFile(const std::string& csvPath, char side, uint32_t partitions, uint64_t& malformed) {
+        std::FILE* input = std::fopen(csvPath.c_str(), "rb");
+        if (!input) {
+            return false;
+        }
+        std::vector<SpillWriter> writers;
+        bool ok = openWriters(writers, side, "", partitions);
+        LineReader reader(input);
+        const char* line;
+        size_t length;
+        while (ok && reader.next(line, length)) {
+            const char* comma = (const char*)std::memchr(line, ',', length);
+            int64_t cents;
+            if (!comma || comma == line || comma - line > UINT16_MAX ||
+                !parseCents(comma + 1, line + length, cents)) {
+                malformed++;
+                continue;
+            }
+            uint16_t idLength = (uint16_t)(comma - line);
+            writers[partitionOf(line, idLength, 0, partitions)].append(line, idLength, cents);
+        }
+        ok = ok && !std::ferror(input);
+        ok = closeWriters(writers) && ok;
+        std::fclose(input);
+        return ok;
+    }
+
+    // Memecah satu file partisi menjadi fanout sub-partisi dengan seed depth
+    bool splitPartition(char side, const std::string& name, uint32_t depth, uint32_t fanout) const {
+        PartitionReader reader;
+        std::vector<SpillWriter> writers;
+        bool ok = reader.open(partitionPath(side, name)) && openWriters(writers, side, name + "_", fanout);
+        const char* id;
+        uint16_t length;
+        int64_t cents;
+        while (ok && reader.next(id, length, cents)) {
+            writers[partitionOf(id, length, depth, fanout)].append(id, length, cents);
+        }
+        ok = ok && reader.ok();
+        return closeWriters(writers) && ok;
+    }
+
+    // Hash table flat untuk sisi build satu partisi: id disalin ke satu arena,
+    // slot berisi hash + posisi id, tanpa alokasi per record
+    struct BuildTable {
+        struct Slot {
+            uint64_t hash;     // 0 = kosong
+            uint64_t idOffset;
+            int64_t cents;
+            uint16_t idLength;
+            bool matched;
+        };
+        std::vector<Slot> slots;
+        std::string arena;
+        size_t mask;
+        size_t count = 0;
+        size_t capacity;   // record maksimum agar tabel terisi paling banyak setengah
+        size_t arenaLimit;
+
+        BuildTable(size_t expected, size_t maxArena) : arenaLimit(maxArena) {
+            size_t size = 16;
+            while (size < expected * 2) {
+                size <<= 1;
+            }
+            slots.assign(size, Slot{0, 0, 0, 0, false});
+            mask = size - 1;
+            capacity = size / 2;
+        }
+
+        bool full(uint16_t nextLength) const {
+            return count >= capacity || (count > 0 && arena.size() + nextLength > arenaLimit);
+        }
+
+        // Id duplikat di sisi build disimpan sebagai entri terpisah
+        void insert(const char* id, uint16_t length, int64_t cents) {
+            uint64_t hash = IdempotencyCache::hashKey(id, length);
+            size_t i = hash & mask;
+            while (slots[i].hash != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = Slot{hash, arena.size(), cents, length, false};
+            arena.append(id, length);
+            count++;
+        }
+
+        // Entri pertama dengan id ini yang belum dipasangkan, atau nullptr
+        Slot* findUnmatched(const char* id, uint16_t length) {
+            uint64_t hash = IdempotencyCache::hashKey(id, length);
+            for (size_t i = hash & mask; slots[i].hash != 0; i = (i + 1) & mask) {
+                Slot& slot = slots[i];
+                if (slot.hash == hash && !slot.matched && slot.idLength == length &&
+                    std::memcmp(arena.data() + slot.idOffset, id, length) == 0) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    /**
+     * Join satu partisi per blok: setiap blok memuat sisi build sebanyak yang
+     * muat di tableLimit, lalu mengalirkan sisi probe. Record probe tanpa
+     * pasangan ditulis ke file sisa dan menjadi probe blok berikutnya; pada
+     * blok terakhir record itu tidak ada di sisi build. Partisi yang muat
+     * hanya butuh satu blok dan tidak menulis file sisa.
+     */
+    bool joinBlocks(const std::string& name, const JoinPlan& plan, JoinSink& sink) {
+        uint64_t buildBytes = fileSize(partitionPath('b', name));
+        size_t expected = (size_t)std::min<uint64_t>(buildBytes / MIN_RECORD_BYTES + 1, blockRecords(plan.tableLimit));
+
+        PartitionReader build;
+        if (!build.open(partitionPath('b', name))) {
+            return false;
+        }
+        const char* id;
+        uint16_t length;
+        int64_t cents;
+        bool pending = build.next(id, length, cents);
+        std::string probePath = partitionPath('p', name);
+        for (uint32_t pass = 0;; pass++) {
+            BuildTable table(expected, plan.tableLimit / 2);
+            while (pending && !table.full(length)) {
+                table.insert(id, length, cents);
+                pending = build.next(id, length, cents);
+            }
+
+            // Blok berikutnya masih ada: probe tanpa pasangan disimpan ke file sisa
+            std::string restPath = partitionPath('q', name + "_" + std::to_string(pass));
+            SpillWriter rest;
+            bool ok = build.ok() && (!pending || rest.open(restPath));
+            PartitionReader probe;
+            ok = ok && probe.open(probePath);
+            const char* probeId;
+            uint16_t probeLength;
+            int64_t probeCents;
+            while (ok && probe.next(probeId, probeLength, probeCents)) {
+                BuildTable::Slot* slot = table.findUnmatched(probeId, probeLength);
+                if (slot) {
+                    slot->matched = true;
+                    sink.pair(probeId, probeLength, slot->cents, probeCents);
+                } else if (pending) {
+                    rest.append(probeId, probeLength, probeCents);
+                } else {
+                    sink.unmatched(probeId, probeLength, probeCents, false);
+                }
+            }
+            ok = ok && probe.ok();
+            ok = rest.close() && ok;
+            if (pass > 0) {
+                std::remove(probePath.c_str());
+            }
+            if (!ok) {
+                std::remove(restPath.c_str());
+                return false;
+            }
+
+            for (const auto& slot : table.slots) {
+                if (slot.hash != 0 && !slot.matched) {
+                    sink.unmatched(table.arena.data() + slot.idOffset, slot.idLength, slot.cents, true);
+                }
+            }
+            if (!pending) {
+                return true;
+            }
+            probePath = restPath;
+        }
+    }
+
+    // Fase 2 untuk satu partisi: pecah ulang jika terlalu besar, jika tidak
+    // build dari sisi build dan probe dengan sisi probe. File partisi selalu dihapus.
+    bool joinPartition(const std::string& name, uint32_t depth, const JoinPlan& plan, JoinSink& sink,
+                       std::atomic<bool>& failed) {
+        std::string buildPath = partitionPath('b', name), probePath = partitionPath('p', name);
+        uint64_t buildBytes = fileSize(buildPath);
+        bool ok = true;
+        if (!fitsInTable(buildBytes, plan.tableLimit) && depth < MAX_DEPTH) {
+            // Sub-partisi cukup banyak agar masing-masing muat dengan ruang untuk
+            // hash yang tidak rata, dibatasi fanout
+            uint32_t fanout = 2;
+            while (fanout < plan.fanout && !fitsInTable(buildBytes / fanout, plan.tableLimit / 2)) {
+                fanout *= 2;
+            }
+            ok = splitPartition('b', name, depth + 1, fanout) && splitPartition('p', name, depth + 1, fanout);
+            std::remove(buildPath.c_str());
+            std::remove(probePath.c_str());
+            sink.summary.repartitions++;
+            for (uint32_t p = 0; p < fanout; p++) {
+                std::string child = name + "_" + std::to_string(p);
+                if (ok && !failed.load(std::memory_order_relaxed)) {
+                    ok = joinPartition(child, depth + 1, plan, sink, failed);
+                } else {
+                    std::remove(partitionPath('b', child).c_str());
+                    std::remove(partitionPath('p', child).c_str());
+                }
+            }
+            return ok;
+        }
+        ok = joinBlocks(name, plan, sink);
+        sink.flush();
+        std::remove(buildPath.c_str());
+        std::remove(probePath.c_str());
+        return ok;
+    }
+
+public:
+    // memoryBudgetBytes: batas kasar memori fase 1 dan 2 semua worker
+    ReconciliationEngine(const std::string& spillDir, size_t memoryBudgetBytes = 256 << 20, unsigned threads = 0)
+        : spillDirectory(spillDir), memoryBudget(memoryBudgetBytes),
+          threadCount(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    // false jika file tidak bisa dibaca/ditulis; summary tetap berisi hitungan
+    // dari partisi yang sudah selesai
+    bool run(const std::string& recordsCsv, const std::string& settlementCsv, const std::string& outputPrefix,
+             ReconciliationSummary& summary) {
+        summary = ReconciliationSummary();
+
+        // Sisi yang lebih kecil dimuat ke hash table, sisi lain hanya dialirkan
+        uint64_t recordsBytes = fileSize(recordsCsv), settlementBytes = fileSize(settlementCsv);
+        JoinPlan plan;
+        plan.buildIsRecords = recordsBytes <= settlementBytes;
+        uint64_t buildBytes = plan.buildIsRecords ? recordsBytes : settlementBytes;
+
+        // Per worker: buffer output (3 x FLUSH_BYTES), dua pembaca partisi dan
+        // satu penulis sisa; sisanya untuk hash table + arena
+        size_t perWorker = memoryBudget / threadCount;
+        size_t fixedBytes = 3 * FLUSH_BYTES + 2 * READ_CHUNK + SPILL_BUFFER;
+        plan.tableLimit = std::max<size_t>(perWorker > fixedBytes ? perWorker - fixedBytes : 0, 1 << 20);
+        plan.fanout = (uint32_t)std::min<size_t>(MAX_PARTITIONS, std::max<size_t>(plan.tableLimit / SPILL_BUFFER, 2));
+
+        // Fase 1 menulis semua partisi sekaligus: buffer spill ikut batas memori.
+        // Partisi juga dibuat cukup kecil agar tabelnya muat di cache: probe ke
+        // tabel sebesar cache ~2x lebih cepat daripada ke tabel di DRAM.
+        uint32_t maxPartitions = (uint32_t)std::min<size_t>(MAX_PARTITIONS, std::max<size_t>(memoryBudget / SPILL_BUFFER, 2));
+        uint64_t perPartitionLimit = std::min<uint64_t>(plan.tableLimit, CACHE_TARGET);
+        uint32_t partitions = threadCount;
+        while (partitions < maxPartitions && !fitsInTable(buildBytes / partitions, perPartitionLimit)) {
+            partitions *= 2;
+        }
+        summary.partitions = partitions;
+
+        const char* suffixes[3] = {"_matched.csv", "_mismatch.csv", "_missing.csv"};
+        SharedOutput outputs[3];
+        plan.outputs = outputs;
+        bool ok = true;
+        for (int i = 0; i < 3; i++) {
+            outputs[i].file = ok ? std::fopen((outputPrefix + suffixes[i]).c_str(), "wb") : nullptr;
+            ok = ok && outputs[i].file;
+        }
+        ok = ok && partitionFile(plan.buildIsRecords ? recordsCsv : settlementCsv, 'b', partitions, summary.malformedLines) &&
+             partitionFile(plan.buildIsRecords ? settlementCsv : recordsCsv, 'p', partitions, summary.malformedLines);
+
+        std::atomic<uint32_t> nextPartition(0);
+        std::atomic<bool> failed(!ok);
+        std::vector<ReconciliationSummary> partial(threadCount);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; ok && t < threadCount; t++) {
+            workers.emplace_back([&, t]() {
+                JoinSink sink{plan, partial[t], {}, {}, {}};
+                for (uint32_t p; (p = nextPartition.fetch_add(1)) < partitions;) {
+                    if (failed.load(std::memory_order_relaxed) ||
+                        !joinPartition(std::to_string(p), 0, plan, sink, failed)) {
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        // Partisi yang tidak sempat di-join (gagal di fase 1 atau worker berhenti)
+        for (uint32_t p = 0; p < partitions; p++) {
+            std::remove(partitionPath('b', std::to_string(p)).c_str());
+            std::remove(partitionPath('p', std::to_string(p)).c_str());
+        }
+        ok = !failed.load();
+        for (auto& output : outputs) {
+            ok = output.close() && ok;
+        }
+        for (const auto& part : partial) {
+            summary.matched += part.matched;
+            summary.amountMismatch += part.amountMismatch;
+            summary.missingInSettlement += part.missingInSettlement;
+            summary.missingInRecords += part.missingInRecords;
+            summary.repartitions += part.repartitions;
+        }
+        return ok;
+    }
+};
+
+// Menulis catatan pembayaran ke CSV "id,jumlah" sebagai sisi catatan rekonsiliasi
+bool writeReconciliationRecords(const std::vector<Payment*>& payments, const std::string& path) {
+    return exporter::writeFile(path, payments, "id,amount\n",
+                               [](exporter::RecordBuffer& out, const Payment* payment, size_t) {
+                                   out.text(payment->getId());
+                                   out.put(',');
+                                   out.fixed(payment->getAmount(), 2);
+                                   out.put('\n');
+                               });
+}
+
+// ===================== Ekspor laporan pembayaran =====================
+
+const char* const PAYMENT_EXPORT_HEADER = "id,amount,date,status,method,reference\n";
+
+// Laporan semua pembayaran sebagai CSV atau JSON Lines; threads = 0 berarti semua core
+bool exportPayments(const std::vector<Payment*>& payments, const std::string& path, exporter::Format format,
+                    unsigned threads = 1, uint64_t* bytesWritten = nullptr) {
+    TRACE_SCOPE("payment.export");
+    return exporter::writeFile(
+        path, payments, format == exporter::Format::CSV ? PAYMENT_EXPORT_HEADER : nullptr,
+        [format](exporter::RecordBuffer& out, const Payment* payment, size_t) { payment->appendRecord(out, format); },
+        threads, bytesWritten);
+}
+
+// Benchmark laporan bulanan: ostream per field (cara displayInfo) vs exporter
+void benchmarkPaymentExport() {
+    const size_t count = 600000;
+    std::vector<std::unique_ptr<Payment>> owned;
+    std::vector<Payment*> payments;
+    owned.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::string n = std::to_string(i);
+        double amount = 10000 + (double)(i * 7919 % 5000000) / 100;
+        if (i % 3 == 0) {
+            owned.push_back(std::make_unique<CreditCardPayment>("CC" + n, amount, "4111111111111111", "12/27", "123"));
+        } else if (i % 3 == 1) {
+            owned.push_back(std::make_unique<BankTransfer>("BT" + n, amount, "98765" + n, "Bank Mandiri", "TRF" + n));
+        } else {
+            owned.push_back(std::make_unique<DigitalWallet>("DW" + n, amount, "user" + n, "GoPay", "0812" + n));
+        }
+        owned.back()->setStatus(i % 10 ? "COMPLETED" : "REFUNDED");
+        payments.push_back(owned.back().get());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream out("export_bench_ostream.csv");
+        out << PAYMENT_EXPORT_HEADER;
+        for (const Payment* p : payments) {
+            out << p->getId() << ',' << std::fixed << std::setprecision(2) << p->getAmount() << ','
+                << p->getDate() << ',' << p->getStatus() << ',' << p->getMethodName() << std::endl;
+        }
+    }
+    double ostreamMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    uint64_t ostreamBytes = (uint64_t)std::ifstream("export_bench_ostream.csv", std::ios::ate | std::ios::binary).tellg();
+
+    std::cout << "metode,ms,MB_per_detik" << std::endl;
+    std::cout << "ostream + endl," << ostreamMs << "," << ostreamBytes / 1e3 / ostreamMs << std::endl;
+    struct Run {
+        const char* name;
+        exporter::Format format;
+        unsigned threads;
+    };
+    for (const Run& run : {Run{"exporter CSV", exporter::Format::CSV, 1},
+                           Run{"exporter CSV semua core", exporter::Format::CSV, 0},
+                           Run{"exporter JSON Lines", exporter::Format::JSON_LINES, 1},
+                           Run{"exporter JSON Lines semua core", exporter::Format::JSON_LINES, 0}}) {
+        uint64_t bytes = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = exportPayments(payments, "export_bench.out", run.format, run.threads, &bytes);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << run.name << (ok ? "," : " (GAGAL),") << ms << "," << bytes / 1e3 / ms << std::endl;
+    }
+    std::remove("export_bench_ostream.csv");
+    std::remove("export_bench.out");
+}
+
+// Benchmark rekonsiliasi file besar: 1% hilang di settlement, 0.5% jumlah beda, 0.5% tambahan
+void benchmarkReconciliation() {
+    const uint32_t lines = 5000000;
+    const std::string recordsPath = "recon_records.csv", settlementPath = "recon_settlement.csv";
+    {
+        std::FILE* records = std::fopen(recordsPath.c_str(), "wb");
+        std::FILE* settlement = std::fopen(settlementPath.c_str(), "wb");
+        if (!records || !settlement) {
+            std::cout << "Tidak bisa membuat file benchmark rekonsiliasi" << std::endl;
+            return;
+        }
+        for (uint32_t i = 0; i < lines; i++) {
+            // Urutan settlement diacak dengan permutasi i * prima mod lines
+            uint32_t j = (uint32_t)((uint64_t)i * 2654435761u % lines);
+            std::fprintf(records, "PAY%08u,%u.%02u\n", i, 10000 + i % 5000000, i % 100);
+            if (j % 100 == 0) {
+                continue;
+            }
+            uint32_t amount = 10000 + j % 5000000 + (j % 200 == 1 ? 1 : 0);
+            std::fprintf(settlement, "PAY%08u,%u.%02u\n", j, amount, j % 100);
+            if (j % 200 == 3) {
+                std::fprintf(settlement, "EXT%08u,100.00\n", j);
+            }
+        }
+        std::fclose(records);
+        std::fclose(settlement);
+    }
+
+    // Batas memori kecil agar benar-benar memakai banyak partisi
+    ReconciliationEngine engine(".", 32 << 20);
+    ReconciliationSummary summary;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = engine.run(recordsPath, settlementPath, "recon_out", summary);
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Rekonsiliasi " << lines << " baris: " << (ok ? "" : "GAGAL, ")
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+              << summary.partitions << " partisi, " << summary.repartitions << " dipecah ulang" << std::endl;
+    std::cout << "cocok=" << summary.matched << ", jumlah beda=" << summary.amountMismatch
+              << ", hilang di settlement=" << summary.missingInSettlement
+              << ", tidak ada di catatan=" << summary.missingInRecords << std::endl;
+    for (const char* path : {"recon_records.csv", "recon_settlement.csv", "recon_out_matched.csv",
+                             "recon_out_mismatch.csv", "recon_out_missing.csv"}) {
+        std::remove(path);
+    }
+}
+
 // Main function untuk testing
 int main() {
+    TRACE_START_EXPORT("tugas_trace.json");
     std::cout << "===== SISTEM PEMBAYARAN DIGITAL =====" << std::endl << std::endl;
 
     // Test CreditCardPayment
@@ -320,6 +1651,64 @@ int main() {
     std::cout << "Status setelah proses: " << dwPayment.getStatus() << std::endl;
     dwPayment.refundPayment();
     std::cout << "Status setelah refund: " << dwPayment.getStatus() << std::endl;
+    std::cout << std::endl;
+
+    // Pengiriman ulang id yang sama tidak diproses dua kali
+    std::cout << "----- IDEMPOTENCY PEMBAYARAN -----" << std::endl;
+    IdempotentPaymentGateway gateway(1000000, 24 * 60 * 60 * 1000);
+    CreditCardPayment retry1("CC002", 750000, "1234567890123456", "12/25", "123");
+    CreditCardPayment retry2("CC002", 750000, "1234567890123456", "12/25", "123");
+    IdempotentPaymentGateway::SubmitStatus submitStatus;
+    gateway.submit(retry1, &submitStatus);
+    std::cout << "Kiriman pertama diproses: " << (submitStatus == IdempotentPaymentGateway::PROCESSED ? "ya" : "tidak") << std::endl;
+    bool retryResult = gateway.submit(retry2, &submitStatus);
+    std::cout << "Kiriman ulang duplikat: " << (submitStatus == IdempotentPaymentGateway::DUPLICATE ? "ya" : "tidak")
+              << ", hasil tersimpan: " << (retryResult ? "berhasil" : "gagal") << std::endl;
+    std::cout << "Status objek kiriman ulang: " << retry2.getStatus() << std::endl;
+    std::cout << std::endl;
+
+    benchmarkIdempotency();
+    std::cout << std::endl;
+
+    // Rekonsiliasi tiga pembayaran di atas terhadap settlement dari bank/provider
+    std::cout << "----- REKONSILIASI SETTLEMENT -----" << std::endl;
+    std::vector<Payment*> processed = {&ccPayment, &btPayment, &dwPayment};
+    writeReconciliationRecords(processed, "records_demo.csv");
+    {
+        std::ofstream settlement("settlement_demo.csv");
+        settlement << "id,amount\nCC001,1500000.00\nBT001,1999000.00\nXX999,5000.00\n";
+    }
+    ReconciliationEngine engine(".");
+    ReconciliationSummary summary;
+    engine.run("records_demo.csv", "settlement_demo.csv", "recon_demo", summary);
+    std::cout << "Cocok: " << summary.matched << ", jumlah beda: " << summary.amountMismatch
+              << ", hilang di settlement: " << summary.missingInSettlement
+              << ", tidak ada di catatan: " << summary.missingInRecords << std::endl;
+    std::ifstream missingFile("recon_demo_missing.csv");
+    for (std::string line; std::getline(missingFile, line);) {
+        std::cout << "  " << line << std::endl;
+    }
+    missingFile.close();
+    for (const char* path : {"records_demo.csv", "settlement_demo.csv", "recon_demo_matched.csv",
+                             "recon_demo_mismatch.csv", "recon_demo_missing.csv"}) {
+        std::remove(path);
+    }
+    std::cout << std::endl;
+
+    benchmarkReconciliation();
+    std::cout << std::endl;
+
+    // Laporan pembayaran sebagai CSV dan JSON Lines
+    std::cout << "----- EKSPOR LAPORAN -----" << std::endl;
+    exportPayments(processed, "payments_demo.jsonl", exporter::Format::JSON_LINES);
+    std::ifstream report("payments_demo.jsonl");
+    for (std::string line; std::getline(report, line);) {
+        std::cout << line << std::endl;
+    }
+    report.close();
+    std::remove("payments_demo.jsonl");
+    benchmarkPaymentExport();
 
+    TRACE_STOP_EXPORT(std::cerr);
     return 0;
 }
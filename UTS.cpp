@@ -1,7 +1,16 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <chrono>
+#include <cstdint>
 using namespace std;
 
+class Pasar;
+
 class User {
 protected:
     string nama, email;
@@ -12,15 +21,20 @@ public:
 };
 
 class Petani : public User {
+public:
+    static constexpr uint32_t BELUM_TERDAFTAR = UINT32_MAX;
 private:
-    vector<string> hasilPanen;
+    uint32_t id = BELUM_TERDAFTAR; // Id petani di Pasar, diisi oleh Pasar::daftarPetani
 public:
     void login() override {
         cout << "Petani " << nama << " berhasil login.\n";
     }
-    void tambahHasil(string produk) {
-        hasilPanen.push_back(produk);
-    }
+    void setId(uint32_t petaniId) { id = petaniId; }
+    uint32_t getId() const { return id; }
+
+    // Hasil panen dicatat di indeks milik pasar, bukan vector<string> per petani.
+    // false jika petani belum didaftarkan ke pasar
+    bool tambahHasil(Pasar& pasar, const string& produk);
 };
 
 class Produk {
@@ -43,15 +57,350 @@ public:
     }
 };
 
+// Statistik harga per produk, diperbarui O(1) per transaksi
+struct StatistikHarga {
+    uint64_t jumlahTransaksi = 0;
+    double totalHarga = 0;
+    double hargaMin = numeric_limits<double>::infinity();
+    double hargaMax = -numeric_limits<double>::infinity();
+    double rataRataBergulir = 0; // exponential moving average
+
+    double rataRata() const { return jumlahTransaksi ? totalHarga / jumlahTransaksi : 0; }
+};
+
+// Satu baris penjualan dalam batch transaksi
+struct Penjualan {
+    uint32_t produkId;
+    double harga;
+};
+
+/**
+ * Mesin marketplace: nama produk di-intern menjadi id integer, hasil panen
+ * disimpan sebagai log ringkas (8 byte per catatan) dan diindeks per petani
+ * serta per produk dalam format CSR (offset + daftar id), sehingga tidak ada
+ * vector/string kecil per petani.
+ *
+ * Catatan baru tidak membuat indeks dibangun ulang saat query. Catatan di
+ * belakang bagian yang sudah masuk CSR dirangkai per kunci sebagai linked list
+ * berindeks (awal/akhir per kunci, berikut per catatan), jadi menambah catatan
+ * O(1) dan query O(jumlah hasil). Delta digabung ke CSR saat ukurannya melewati
+ * bagian yang sudah terindeks (dan jumlah kunci), sehingga biaya penggabungan
+ * teramortisasi O(1) per catatan walaupun tulis dan query berselang-seling.
+ *
+ * Id petani/produk yang tidak dikenal ditolak (false / dihitung sebagai
+ * ditolak), bukan ditulis ke luar array.
+ */
+class Pasar {
+private:
+    static constexpr uint32_t TIDAK_ADA = UINT32_MAX;
+    static constexpr size_t DELTA_MINIMUM = 4096;
+
+    struct CatatanPanen {
+        uint32_t petaniId;
+        uint32_t produkId;
+    };
+
+    // Linked list berindeks untuk catatan yang belum masuk CSR
+    struct DaftarDelta {
+        vector<uint32_t> awal, akhir; // per kunci, TIDAK_ADA jika kosong
+        vector<uint32_t> berikut;     // per catatan delta
+
+        void tambahKunci() {
+            awal.push_back(TIDAK_ADA);
+            akhir.push_back(TIDAK_ADA);
+        }
+
+        void tambah(uint32_t kunci, uint32_t posisi) {
+            berikut.push_back(TIDAK_ADA);
+            if (awal[kunci] == TIDAK_ADA) {
+                awal[kunci] = posisi;
+            } else {
+                berikut[akhir[kunci]] = posisi;
+            }
+            akhir[kunci] = posisi;
+        }
+
+        void kosongkan() {
+            fill(awal.begin(), awal.end(), TIDAK_ADA);
+            fill(akhir.begin(), akhir.end(), TIDAK_ADA);
+            berikut.clear();
+        }
+
+        size_t kapasitasByte() const {
+            return (awal.capacity() + akhir.capacity() + berikut.capacity()) * sizeof(uint32_t);
+        }
+    };
+
+    // Intern nama produk
+    unordered_map<string, uint32_t> idProduk;
+    vector<string> namaProduk;
+
+    uint32_t jumlahPetani = 0;
+    vector<CatatanPanen> logPanen;
+
+    // Indeks CSR untuk logPanen[0 .. jumlahTerindeks): produk milik petani p ada di
+    // produkPerPetani[offsetPetani[p] .. offsetPetani[p+1]); kunci yang didaftarkan
+    // setelah penggabungan terakhir belum punya offset (rentang CSR-nya kosong)
+    vector<uint32_t> offsetPetani, produkPerPetani;
+    vector<uint32_t> offsetProduk, petaniPerProduk;
+    size_t jumlahTerindeks = 0;
+    DaftarDelta deltaPetani, deltaProduk; // posisi delta i = logPanen[jumlahTerindeks + i]
+
+    vector<StatistikHarga> statistik;
+    double bobotBergulir;
+
+    // Counting sort log panen menjadi indeks CSR
+    static void bangunCSR(const vector<CatatanPanen>& log, size_t jumlahKunci, bool kunciPetani,
+                          vector<uint32_t>& offset, vector<uint32_t>& isi) {
+        offset.assign(jumlahKunci + 1, 0);
+        for (const auto& c : log) {
+            offset[(kunciPetani ? c.petaniId : c.produkId) + 1]++;
+        }
+        for (size_t i = 0; i < jumlahKunci; i++) {
+            offset[i + 1] += offset[i];
+        }
+        isi.resize(log.size());
+        vector<uint32_t> posisi(offset.begin(), offset.end() - 1);
+        for (const auto& c : log) {
+            uint32_t kunci = kunciPetani ? c.petaniId : c.produkId;
+            isi[posisi[kunci]++] = kunciPetani ? c.produkId : c.petaniId;
+        }
+    }
+
+    // Memindahkan semua catatan delta ke CSR
+    void gabungkanDelta() {
+        bangunCSR(logPanen, jumlahPetani, true, offsetPetani, produkPerPetani);
+        bangunCSR(logPanen, namaProduk.size(), false, offsetProduk, petaniPerProduk);
+        jumlahTerindeks = logPanen.size();
+        deltaPetani.kosongkan();
+        deltaProduk.kosongkan();
+    }
+
+    // Isi CSR kunci lalu catatan delta-nya, sesuai urutan pencatatan
+    vector<uint32_t> daftarUntuk(uint32_t kunci, const vector<uint32_t>& offset, const vector<uint32_t>& isi,
+                                 const DaftarDelta& delta, bool kunciPetani) const {
+        vector<uint32_t> hasil;
+        if ((size_t)kunci + 1 < offset.size()) {
+            hasil.assign(isi.begin() + offset[kunci], isi.begin() + offset[kunci + 1]);
+        }
+        for (uint32_t i = delta.awal[kunci]; i != TIDAK_ADA; i = delta.berikut[i]) {
+            const CatatanPanen& c = logPanen[jumlahTerindeks + i];
+            hasil.push_back(kunciPetani ? c.produkId : c.petaniId);
+        }
+        return hasil;
+    }
+
+public:
+    // bobot: porsi harga terbaru dalam rata-rata bergulir (0..1)
+    explicit Pasar(double bobot = 0.1) : bobotBergulir(bobot) {}
+
+    uint32_t daftarPetani(Petani& petani) {
+        uint32_t id = daftarPetaniBaru();
+        petani.setId(id);
+        return id;
+    }
+
+    // Id baru untuk petani tanpa objek Petani (misalnya impor data massal)
+    uint32_t daftarPetaniBaru() {
+        deltaPetani.tambahKunci();
+        return jumlahPetani++;
+    }
+
+    uint32_t internProduk(const string& nama) {
+        auto it = idProduk.find(nama);
+        if (it != idProduk.end()) {
+            return it->second;
+        }
+        uint32_t id = (uint32_t)namaProduk.size();
+        idProduk.emplace(nama, id);
+        namaProduk.push_back(nama);
+        statistik.emplace_back();
+        deltaProduk.tambahKunci();
+        return id;
+    }
+
+    const string& getNamaProduk(uint32_t id) const { return namaProduk[id]; }
+
+    bool petaniValid(uint32_t petaniId) const { return petaniId < jumlahPetani; }
+    bool produkValid(uint32_t produkId) const { return produkId < namaProduk.size(); }
+
+    // false jika petani atau produk belum terdaftar
+    bool catatPanen(uint32_t petaniId, uint32_t produkId) {
+        if (!petaniValid(petaniId) || !produkValid(produkId)) {
+            return false;
+        }
+        uint32_t posisi = (uint32_t)(logPanen.size() - jumlahTerindeks);
+        logPanen.push_back({petaniId, produkId});
+        deltaPetani.tambah(petaniId, posisi);
+        deltaProduk.tambah(produkId, posisi);
+        if (logPanen.size() - jumlahTerindeks > max({jumlahTerindeks, (size_t)jumlahPetani + namaProduk.size(),
+                                                     DELTA_MINIMUM})) {
+            gabungkanDelta();
+        }
+        return true;
+    }
+
+    // Daftar id produk hasil panen seorang petani (kosong jika id tidak dikenal)
+    vector<uint32_t> hasilPetani(uint32_t petaniId) const {
+        if (!petaniValid(petaniId)) {
+            return {};
+        }
+        return daftarUntuk(petaniId, offsetPetani, produkPerPetani, deltaPetani, true);
+    }
+
+    // Jumlah catatan panen untuk sebuah produk (dari semua petani)
+    uint32_t jumlahPanenProduk(uint32_t produkId) const {
+        if (!produkValid(produkId)) {
+            return 0;
+        }
+        uint32_t jumlah = (size_t)produkId + 1 < offsetProduk.size()
+                              ? offsetProduk[produkId + 1] - offsetProduk[produkId]
+                              : 0;
+        for (uint32_t i = deltaProduk.awal[produkId]; i != TIDAK_ADA; i = deltaProduk.berikut[i]) {
+            jumlah++;
+        }
+        return jumlah;
+    }
+
+    // Daftar id petani yang memanen sebuah produk
+    vector<uint32_t> petaniProduk(uint32_t produkId) const {
+        if (!produkValid(produkId)) {
+            return {};
+        }
+        return daftarUntuk(produkId, offsetProduk, petaniPerProduk, deltaProduk, false);
+    }
+
+    // Memproses satu batch penjualan dan memperbarui statistik harga per produk.
+    // Baris dengan produk tidak dikenal atau harga bukan angka dilewati;
+    // mengembalikan jumlah baris yang ditolak
+    size_t prosesBatch(const vector<Penjualan>& batch) {
+        size_t ditolak = 0;
+        for (const auto& jual : batch) {
+            if (!produkValid(jual.produkId) || jual.harga != jual.harga) {
+                ditolak++;
+                continue;
+            }
+            StatistikHarga& s = statistik[jual.produkId];
+            s.rataRataBergulir = s.jumlahTransaksi == 0
+                                     ? jual.harga
+                                     : s.rataRataBergulir + bobotBergulir * (jual.harga - s.rataRataBergulir);
+            s.jumlahTransaksi++;
+            s.totalHarga += jual.harga;
+            s.hargaMin = min(s.hargaMin, jual.harga);
+            s.hargaMax = max(s.hargaMax, jual.harga);
+        }
+        return ditolak;
+    }
+
+    const StatistikHarga& getStatistik(uint32_t produkId) const { return statistik[produkId]; }
+
+    // Perkiraan memori struktur data utama (tanpa nama produk)
+    size_t perkiraanMemori() const {
+        return logPanen.capacity() * sizeof(CatatanPanen) +
+               (offsetPetani.capacity() + produkPerPetani.capacity() + offsetProduk.capacity() +
+                petaniPerProduk.capacity()) * sizeof(uint32_t) +
+               deltaPetani.kapasitasByte() + deltaProduk.kapasitasByte() +
+               statistik.capacity() * sizeof(StatistikHarga);
+    }
+};
+
+bool Petani::tambahHasil(Pasar& pasar, const string& produk) {
+    if (id == BELUM_TERDAFTAR || !pasar.petaniValid(id)) {
+        return false;
+    }
+    return pasar.catatPanen(id, pasar.internProduk(produk));
+}
+
+// Benchmark skala besar: jutaan petani, catatan panen dan transaksi
+void benchmarkPasar() {
+    const uint32_t jumlahPetani = 1000000;
+    const uint32_t jumlahProduk = 10000;
+    const size_t jumlahPanen = 4000000;
+    const size_t jumlahTransaksi = 4000000;
+    const size_t ukuranBatch = 65536;
+
+    Pasar pasar;
+    for (uint32_t i = 0; i < jumlahProduk; i++) {
+        pasar.internProduk("Produk-" + to_string(i));
+    }
+    for (uint32_t i = 0; i < jumlahPetani; i++) {
+        pasar.daftarPetaniBaru();
+    }
+
+    mt19937 rng(11);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < jumlahPanen; i++) {
+        pasar.catatPanen(rng() % jumlahPetani, rng() % jumlahProduk);
+    }
+    auto t1 = chrono::steady_clock::now();
+
+    // Tulis dan query berselang-seling: tidak ada pembangunan ulang indeks per query
+    const size_t jumlahSelang = 1000000;
+    size_t totalHasil = 0;
+    auto s0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < jumlahSelang; i++) {
+        uint32_t petaniId = rng() % jumlahPetani;
+        pasar.catatPanen(petaniId, rng() % jumlahProduk);
+        totalHasil += pasar.hasilPetani(petaniId).size();
+    }
+    auto s1 = chrono::steady_clock::now();
+
+    vector<Penjualan> batch;
+    batch.reserve(ukuranBatch);
+    uniform_real_distribution<double> harga(5000.0, 50000.0);
+    double waktuBatch = 0;
+    for (size_t i = 0; i < jumlahTransaksi; i++) {
+        batch.push_back({(uint32_t)(rng() % jumlahProduk), harga(rng)});
+        if (batch.size() == ukuranBatch || i + 1 == jumlahTransaksi) {
+            auto b0 = chrono::steady_clock::now();
+            pasar.prosesBatch(batch);
+            waktuBatch += chrono::duration<double, milli>(chrono::steady_clock::now() - b0).count();
+            batch.clear();
+        }
+    }
+
+    const StatistikHarga& s = pasar.getStatistik(0);
+    cout << "Catat + indeks " << jumlahPanen << " panen: "
+         << chrono::duration<double, milli>(t1 - t0).count() << " ms" << endl;
+    cout << "Catat + query berselang " << jumlahSelang << " kali: "
+         << chrono::duration<double, milli>(s1 - s0).count() << " ms (" << totalHasil << " hasil)" << endl;
+    cout << "Proses " << jumlahTransaksi << " transaksi: " << waktuBatch << " ms" << endl;
+    cout << "Statistik " << pasar.getNamaProduk(0) << ": n=" << s.jumlahTransaksi << ", rata-rata="
+         << s.rataRata() << ", bergulir=" << s.rataRataBergulir << ", min=" << s.hargaMin << ", max="
+         << s.hargaMax << endl;
+    cout << "Perkiraan memori: " << pasar.perkiraanMemori() / (1024 * 1024) << " MB" << endl;
+}
+
 int main() {
+    Pasar pasar;
+
     Petani petani;
     petani.setNama("Budi");
+    pasar.daftarPetani(petani);
     petani.login();
+    petani.tambahHasil(pasar, "Bawang Merah");
+    petani.tambahHasil(pasar, "Cabai Rawit");
+
+    Petani tamu;
+    tamu.setNama("Tamu");
+    cout << "Panen petani yang belum terdaftar diterima: " << (tamu.tambahHasil(pasar, "Jagung") ? "ya" : "tidak")
+         << endl;
 
     Produk p1("Bawang Merah", 12000.0);
     Transaksi t(&p1);
     t.proses();
 
+    // Transaksi diproses per batch dengan statistik harga per produk
+    uint32_t bawang = pasar.internProduk(p1.getNama());
+    pasar.prosesBatch({{bawang, p1.getHarga()}, {bawang, 13000.0}, {bawang, 11500.0}});
+    const StatistikHarga& s = pasar.getStatistik(bawang);
+    cout << "Hasil panen Budi:";
+    for (uint32_t id : pasar.hasilPetani(petani.getId())) {
+        cout << " " << pasar.getNamaProduk(id);
+    }
+    cout << "\nHarga " << p1.getNama() << ": rata-rata " << s.rataRata() << ", min " << s.hargaMin
+         << ", max " << s.hargaMax << endl;
+
+    benchmarkPasar();
     return 0;
 }
-
@@ -0,0 +1,460 @@
+/**
+ * @file benchmark.cpp
+ * @brief Benchmark gabungan untuk hot path setiap modul di repository ini
+ *
+ * Setiap program dimasukkan ke namespace sendiri (kelas seperti User dan
+ * Payment ada di beberapa file), sehingga kode aslinya dipakai apa adanya.
+ * Header standar di-include lebih dulu di global scope agar include di
+ * dalam namespace tidak berpengaruh.
+ *
+ * Build dan jalankan (target benchmark dan benchmark_traced di CMakeLists.txt):
+ *     cmake -S . -B build && cmake --build build --target benchmark
+ *     ./build/benchmark [skala] > hasil.jsonl
+ *
+ * atau langsung: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+ *
+ * benchmark_traced (-DENABLE_TRACING) mengukur modul dengan instrumentasi
+ * aktif (lihat instrumentation.h) beserta biaya satu span/counter.
+ *
+ * Output: satu objek JSON per baris (JSON Lines) berisi ns/op, alokasi/op
+ * dan persentil p50/p90/p99. Persentil dihitung dari rata-rata per sampel
+ * (satu sampel = beberapa operasi berturut-turut) agar overhead pengukuran
+ * waktu tidak mendominasi operasi yang sangat singkat.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <queue>
+#include <tuple>
+#include <optional>
+#include <variant>
+#include <unordered_map>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include <filesystem>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <future>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+// Di global scope, agar makro TRACE_* di setiap modul memakai ::trace yang sama
+#include "instrumentation.h"
+// Dipakai Tugas.cpp dan Class Diagram.cpp; satu salinan di global scope
+#include "record_export.h"
+
+namespace tugas {
+#include "Tugas.cpp"
+}
+namespace tugas1 {
+#include "tugas1.cpp"
+}
+namespace tugas2 {
+#include "tugas2.cpp"
+}
+namespace classdiagram {
+#include "Class Diagram.cpp"
+}
+namespace transportku {
+#include "traansportku.cpp"
+}
+namespace graph {
+#include "graph.cpp"
+}
+namespace bst {
+#include "binary tree.cpp"
+}
+
+// ===================== Penghitung alokasi =====================
+
+static std::atomic<uint64_t> allocationCount(0);
+
+// operator new di bawah memakai malloc, jadi free di operator delete memang
+// pasangannya; GCC tetap memberi peringatan palsu untuk kombinasi ini
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// ===================== Harness =====================
+
+// Output benchmark ditulis ke stdout asli; std::cout milik modul dibuang
+static std::ostream* report = nullptr;
+
+// Hasil operasi ditulis ke sini agar compiler tidak membuang operasi yang diukur
+static volatile double sinkValue = 0;
+
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+/**
+ * @brief Menjalankan op(i) untuk i = 0..iterations-1 dan melaporkan hasilnya
+ *
+ * @param name        Nama benchmark (modul.fungsi)
+ * @param iterations  Jumlah operasi
+ * @param opsPerSample Jumlah operasi per sampel waktu untuk persentil
+ * @param op          Operasi yang diukur
+ */
+template <typename Op>
+void runBenchmark(const std::string& name, size_t iterations, size_t opsPerSample, Op op) {
+    std::vector<double> samples;
+    samples.reserve(iterations / opsPerSample + 1);
+
+    uint64_t allocBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations;) {
+        size_t end = std::min(iterations, i + opsPerSample);
+        auto sampleStart = std::chrono::steady_clock::now();
+        for (size_t j = i; j < end; j++) {
+            op(j);
+        }
+        auto sampleEnd = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(sampleEnd - sampleStart).count() / (end - i));
+        i = end;
+    }
+    auto finish = std::chrono::steady_clock::now();
+    // Alokasi vector samples sudah di-reserve, jadi tidak ikut terhitung
+    uint64_t allocs = allocationCount.load() - allocBefore;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))];
+    };
+    double nsPerOp = std::chrono::duration<double, std::nano>(finish - start).count() / iterations;
+
+    *report << std::fixed << std::setprecision(2)
+            << "{\"benchmark\":\"" << name << "\",\"iterations\":" << iterations
+            << ",\"ns_per_op\":" << nsPerOp
+            << ",\"allocs_per_op\":" << (double)allocs / iterations
+            << ",\"p50_ns\":" << percentile(0.50)
+            << ",\"p90_ns\":" << percentile(0.90)
+            << ",\"p99_ns\":" << percentile(0.99) << "}" << std::endl;
+}
+
+// ===================== Benchmark per modul =====================
+
+void benchmarkPayments(size_t scale) {
+    tugas::CreditCardPayment card("CC001", 1500000, "1234567890123456", "12/25", "123");
+    tugas::BankTransfer bank("BT001", 2000000, "9876543210", "Bank Mandiri", "TRF123456");
+    tugas::DigitalWallet wallet("DW001", 500000, "user123", "GoPay", "08123456789");
+    tugas::Payment* payments[] = {&card, &bank, &wallet};
+
+    runBenchmark("tugas.processPayment", 100000 * scale, 100, [&](size_t i) {
+        payments[i % 3]->processPayment();
+    });
+    runBenchmark("tugas.refundPayment", 100000 * scale, 100, [&](size_t i) {
+        tugas::Payment* payment = payments[i % 3];
+        payment->setStatus("COMPLETED");
+        payment->refundPayment();
+    });
+
+    tugas::IdempotentPaymentGateway gateway(1000000, 60 * 60 * 1000);
+    gateway.submit(card);
+    runBenchmark("tugas.IdempotentPaymentGateway.submit_duplicate", 1000000 * scale, 1000, [&](size_t) {
+        gateway.submit(card);
+    });
+
+    // Buffer dikosongkan per sampel agar ukurannya tidak tumbuh tanpa batas
+    exporter::RecordBuffer buffer;
+    runBenchmark("tugas.Payment.appendRecord_csv", 1000000 * scale, 1000, [&](size_t i) {
+        if (i % 1000 == 0) {
+            buffer.clear();
+        }
+        payments[i % 3]->appendRecord(buffer, exporter::Format::CSV);
+    });
+}
+
+void benchmarkNotifications(size_t scale) {
+    const size_t perManager = 1000;
+    tugas1::NotificationManager manager;
+    for (size_t i = 0; i < perManager; i++) {
+        if (i % 3 == 0) {
+            manager.addNotification(std::make_unique<tugas1::EmailNotification>("Selamat datang di sistem kami!"));
+        } else if (i % 3 == 1) {
+            manager.addNotification(std::make_unique<tugas1::SMSNotification>("Transaksi berhasil diproses."));
+        } else {
+            manager.addNotification(std::make_unique<tugas1::PushNotification>("Ada pembaruan baru tersedia."));
+        }
+    }
+    // Satu operasi = mengirim seluruh 1000 notifikasi
+    runBenchmark("tugas1.sendAllNotifications_x1000", 100 * scale, 1, [&](size_t) {
+        manager.sendAllNotifications();
+    });
+
+    const size_t recipientCount = 100000;
+    tugas1::RecipientList recipients(3);
+    for (size_t i = 0; i < recipientCount; i++) {
+        recipients.add({"Pelanggan" + std::to_string(i), "TRX" + std::to_string(i), std::to_string(10000 + i)});
+    }
+    tugas1::MessageTemplate message("Halo {nama}, transaksi {id} sebesar Rp{jumlah} berhasil diproses.",
+                                    {"nama", "id", "jumlah"});
+    runBenchmark("tugas1.MessageTemplate.render", 1000000 * scale, 1000, [&](size_t i) {
+        sinkValue = (double)message.render(recipients, i % recipientCount).size();
+    });
+}
+
+void benchmarkAbilities(size_t scale) {
+    tugas2::Player hero("Pahlawan", 100, 5);
+    tugas2::Enemy goblin("Goblin Jahat", std::numeric_limits<int>::max(), "Prajurit");
+    hero.addAbility(std::make_unique<tugas2::AttackAbility>(&hero, &goblin, 1));
+    hero.addAbility(std::make_unique<tugas2::HealingAbility>(&hero, 30));
+    hero.addAbility(std::make_unique<tugas2::DefendAbility>(&hero, 15));
+
+    runBenchmark("tugas2.executeAbility", 300000 * scale, 100, [&](size_t i) {
+        hero.executeAbility(i % 3);
+    });
+}
+
+void benchmarkOrders(size_t scale) {
+    std::vector<classdiagram::Product> products;
+    for (int i = 0; i < 100; i++) {
+        products.emplace_back("Produk" + std::to_string(i), "Kategori", 10.0 + i, 100);
+    }
+    classdiagram::Order order;
+    for (int i = 0; i < 1000; i++) {
+        order.addItem(&products[i % products.size()], 1 + i % 5);
+    }
+    // Satu operasi = total order berisi 1000 item
+    runBenchmark("classdiagram.getTotalAmount_x1000", 10000 * scale, 10, [&](size_t) {
+        sinkValue = order.getTotalAmount();
+    });
+
+    exporter::RecordBuffer buffer(1 << 25);
+    runBenchmark("classdiagram.Order.appendRecord_json_x1000", 1000 * scale, 1, [&](size_t i) {
+        buffer.clear();
+        order.appendRecord(buffer, exporter::Format::JSON_LINES, i);
+    });
+}
+
+// Riwayat order 30 hari per skala (10000 order per hari) di direktori sementara
+void benchmarkOrderHistory(size_t scale) {
+    const uint32_t days = 30 * (uint32_t)scale, ordersPerDay = 10000, productCount = 5000;
+    const std::filesystem::path dir = classdiagram::createTempDirectory("order_history_bench");
+
+    std::vector<classdiagram::Product> products;
+    for (uint32_t p = 0; p < productCount; p++) {
+        products.emplace_back("Produk" + std::to_string(p), "Kategori" + std::to_string(p % 20),
+                              1.0 + (p * 37 % 10000) / 100.0, 1000);
+    }
+    std::mt19937 rng(9);
+    std::vector<classdiagram::Order> orders(1024);
+    for (auto& order : orders) {
+        int items = 1 + rng() % 5;
+        for (int i = 0; i < items; i++) {
+            order.addItem(&products[rng() % productCount], 1 + rng() % 3);
+        }
+    }
+    uint32_t firstDay = (uint32_t)(std::time(nullptr) / 86400) - days;
+    {
+        classdiagram::OrderHistoryStore store(dir.string());
+        runBenchmark("classdiagram.OrderHistoryStore.append", (size_t)days * ordersPerDay, 1000, [&](size_t i) {
+            classdiagram::Order& order = orders[i & (orders.size() - 1)];
+            order.setDay(firstDay + (uint32_t)(i / ordersPerDay));
+            store.append(order);
+        });
+    }
+
+    runBenchmark("classdiagram.OrderHistoryStore.open", 5 * scale, 1, [&](size_t) {
+        classdiagram::OrderHistoryStore store(dir.string());
+        sinkValue = (double)store.segmentCount();
+    });
+    {
+        classdiagram::OrderHistoryStore store(dir.string());
+        classdiagram::OrderQuery lastWeek;
+        lastWeek.fromDay = firstDay + days - 7;
+        lastWeek.categoryId = store.findCategory("Kategori3");
+        runBenchmark("classdiagram.OrderHistoryStore.revenueByCategory", 10 * scale, 1, [&](size_t) {
+            sinkValue = store.revenueByCategory()[0].second;
+        });
+        runBenchmark("classdiagram.OrderHistoryStore.topProducts", 10 * scale, 1, [&](size_t) {
+            sinkValue = store.topProducts(5)[0].second;
+        });
+        runBenchmark("classdiagram.OrderHistoryStore.dailyTotals", 10 * scale, 1, [&](size_t) {
+            sinkValue = store.dailyTotals()[0].second;
+        });
+        runBenchmark("classdiagram.OrderHistoryStore.dailyTotals_7d_category", 10 * scale, 1, [&](size_t) {
+            sinkValue = store.dailyTotals(lastWeek)[0].second;
+        });
+    }
+    std::filesystem::remove_all(dir);
+}
+
+void benchmarkWallet(size_t scale) {
+    transportku::User user(101, "Budi", 1e15);
+    runBenchmark("transportku.pay", 300000 * scale, 100, [&](size_t) {
+        user.pay(15000);
+    });
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> offset(0.0, 0.27);
+    std::vector<std::unique_ptr<transportku::BikeSharing>> owned;
+    std::vector<transportku::BikeSharing*> stations;
+    for (int i = 0; i < 50000; i++) {
+        owned.push_back(std::make_unique<transportku::BikeSharing>(i, "Station", -6.2 + offset(rng),
+                                                                   106.8 + offset(rng), 20, i % 21));
+        stations.push_back(owned.back().get());
+    }
+    transportku::StationIndex index(stations);
+    transportku::NearbyStation nearby[5];
+    runBenchmark("transportku.StationIndex.nearestWithBike", 300000 * scale, 100, [&](size_t i) {
+        stations[i % stations.size()]->rent() || stations[i % stations.size()]->returnBike();
+        sinkValue = (double)index.nearestWithBike(-6.2 + offset(rng), 106.8 + offset(rng), 500.0, 5, nearby);
+    });
+}
+
+void benchmarkGraph(size_t scale) {
+    const int scaleBits = 14;
+    std::vector<std::pair<int, int>> edges;
+    for (const auto& e : graph::generatePowerLawEdges(scaleBits, 8, 1)) {
+        edges.push_back(e);
+        edges.push_back({e.second, e.first});
+    }
+    graph::Graph g;
+    g.loadEdges(1 << scaleBits, edges);
+    runBenchmark("graph.BFSLevels", 20 * scale, 1, [&](size_t) {
+        g.BFSLevels("0");
+    });
+    runBenchmark("graph.parallelBFSLevels", 20 * scale, 1, [&](size_t) {
+        g.parallelBFSLevels("0");
+    });
+    runBenchmark("graph.dijkstra", 20 * scale, 1, [&](size_t) {
+        g.dijkstra("0");
+    });
+}
+
+void benchmarkBST(size_t scale) {
+    const size_t n = 1 << 20;
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = (int)(2 * i);
+    }
+    bst::AVLSet<int> avl;
+    for (int key : keys) {
+        avl.insert(key, bst::NoValue());
+    }
+    bst::EytzingerTree table(keys);
+
+    std::vector<int> queries(1 << 16);
+    std::mt19937 rng(3);
+    for (auto& q : queries) {
+        q = (int)(rng() % (2 * n));
+    }
+    size_t mask = queries.size() - 1;
+    runBenchmark("bst.AVLSet.contains", 1000000 * scale, 1000, [&](size_t i) {
+        sinkValue = avl.contains(queries[i & mask]);
+    });
+    runBenchmark("bst.EytzingerTree.lowerBound", 1000000 * scale, 1000, [&](size_t i) {
+        sinkValue = table.lowerBound(queries[i & mask]) != nullptr;
+    });
+}
+
+#ifdef ENABLE_TRACING
+// Dijalankan dengan eksportir aktif agar span yang disampel ikut menulis ring
+void benchmarkTracing(size_t scale) {
+    // Dua pembacaan jam = biaya tambahan satu span yang disampel
+    runBenchmark("trace.clock", 1000000 * scale, 1000, [](size_t) {
+        uint64_t start = ::trace::now();
+        sinkValue = (double)(::trace::now() - start);
+    });
+    runBenchmark("trace.scope", 1000000 * scale, 1000, [](size_t) {
+        TRACE_SCOPE("benchmark.scope");
+    });
+    runBenchmark("trace.count", 1000000 * scale, 1000, [](size_t) {
+        TRACE_COUNT("benchmark.count");
+    });
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    // Skala mengalikan jumlah iterasi setiap benchmark
+    size_t scale = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1;
+    if (scale == 0) {
+        scale = 1;
+    }
+
+    // Modul menulis ke std::cout di hot path; arahkan ke buffer kosong
+    NullBuffer nullBuffer;
+    std::ostream realOut(std::cout.rdbuf());
+    report = &realOut;
+    std::cout.rdbuf(&nullBuffer);
+
+    benchmarkPayments(scale);
+    benchmarkNotifications(scale);
+    benchmarkAbilities(scale);
+    benchmarkOrders(scale);
+    benchmarkOrderHistory(scale);
+    benchmarkWallet(scale);
+    benchmarkGraph(scale);
+    benchmarkBST(scale);
+#ifdef ENABLE_TRACING
+    std::string tracePath = (std::filesystem::temp_directory_path() / "benchmark_trace.json").string();
+    TRACE_START_EXPORT(tracePath.c_str());
+    benchmarkTracing(scale);
+    TRACE_STOP_EXPORT(*report);
+    std::filesystem::remove(tracePath);
+#endif
+
+    std::cout.rdbuf(realOut.rdbuf());
+    return 0;
+}
@@ -0,0 +1,1363 @@
+/**
+ * @file bst_functions.cpp
+ * @brief Implementasi fungsi-fungsi untuk Binary Search Tree (BST)
+ *
+ * File ini berisi implementasi fungsi-fungsi:
+ * - findMin: mencari node dengan nilai terkecil dalam BST
+ * - findMax: mencari node dengan nilai terbesar dalam BST
+ * - height: menghitung tinggi/kedalaman maksimum dari BST
+ * - countLeaves: menghitung jumlah node daun (leaf) dalam BST
+ * - AVLMap: ordered map/set seimbang (AVL) dengan node dari pool allocator
+ * - EytzingerTree: tabel lookup statis read-only dengan layout Eytzinger
+ * - ConcurrentBSTMap: BST konkuren dengan pembacaan lock-free
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Prefetch sebagai petunjuk ke CPU; tanpa dukungan compiler menjadi no-op
+#if defined(__GNUC__)
+#define BST_PREFETCH(p) __builtin_prefetch(p)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define BST_PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+#define BST_PREFETCH(p) ((void)0)
+#endif
+
+// Definisi struktur Node untuk Binary Search Tree
+struct Node {
+    int data;         // Nilai yang disimpan pada node
+    Node* left;       // Pointer ke anak kiri
+    Node* right;      // Pointer ke anak kanan
+
+    // Constructor
+    Node(int value) {
+        data = value;
+        left = nullptr;
+        right = nullptr;
+    }
+};
+
+/**
+ * @brief Mencari node dengan nilai terkecil dalam BST
+ *
+ * Fungsi ini mencari node dengan nilai terkecil dalam BST dengan
+ * cara traversal ke kiri sampai menemukan node paling kiri
+ * (yang tidak memiliki anak kiri lagi).
+ *
+ * @param root Pointer ke root node dari BST atau sub-tree
+ * @return Node* Pointer ke node dengan nilai terkecil
+ *
+ * Contoh:
+ *     Untuk BST:      10
+ *                   /    \
+ *                  5     15
+ *                 / \    / \
+ *                3   7  12  20
+ *
+ *     findMin(root) akan mengembalikan node dengan nilai 3
+ */
+Node* findMin(Node* root) {
+    // Basis kasus: tree kosong
+    if (root == nullptr) {
+        return nullptr;
+    }
+
+    // Turun ke kiri sampai node yang tidak memiliki anak kiri
+    while (root->left != nullptr) {
+        root = root->left;
+    }
+    return root;
+}
+
+/**
+ * @brief Mencari node dengan nilai terbesar dalam BST
+ *
+ * Fungsi ini mencari node dengan nilai terbesar dalam BST dengan
+ * cara traversal ke kanan sampai menemukan node paling kanan
+ * (yang tidak memiliki anak kanan lagi).
+ *
+ * @param root Pointer ke root node dari BST atau sub-tree
+ * @return Node* Pointer ke node dengan nilai terbesar
+ *
+ * Contoh:
+ *     Untuk BST:      10
+ *                   /    \
+ *                  5     15
+ *                 / \    / \
+ *                3   7  12  20
+ *
+ *     findMax(root) akan mengembalikan node dengan nilai 20
+ */
+Node* findMax(Node* root) {
+    // Basis kasus: tree kosong
+    if (root == nullptr) {
+        return nullptr;
+    }
+
+    // Turun ke kanan sampai node yang tidak memiliki anak kanan
+    while (root->right != nullptr) {
+        root = root->right;
+    }
+    return root;
+}
+
+// Hasil scan satu kali seluruh tree
+struct TreeStats {
+    int height;  // -1 untuk tree kosong
+    long long leaves;
+};
+
+/**
+ * @brief Menghitung tinggi dan jumlah daun dalam satu traversal iteratif
+ *
+ * Menggunakan stack eksplisit berisi (node, kedalaman), sehingga tree
+ * yang sangat dalam tidak membuat stack overflow.
+ *
+ * @param root Pointer ke root node dari BST atau sub-tree
+ * @return TreeStats Tinggi dan jumlah daun
+ */
+TreeStats scanTree(Node* root) {
+    TreeStats stats = {-1, 0};
+    std::vector<std::pair<Node*, int>> stack;
+    if (root != nullptr) {
+        stack.push_back({root, 0});
+    }
+    while (!stack.empty()) {
+        Node* node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        stats.height = std::max(stats.height, depth);
+        if (node->left == nullptr && node->right == nullptr) {
+            stats.leaves++;
+        }
+        if (node->left != nullptr) {
+            stack.push_back({node->left, depth + 1});
+        }
+        if (node->right != nullptr) {
+            stack.push_back({node->right, depth + 1});
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief Versi fork-join paralel dari scanTree
+ *
+ * Pada forkDepth level teratas, subtree kiri dikerjakan thread lain
+ * (std::async) sementara thread saat ini mengerjakan subtree kanan.
+ * Di bawah level tersebut setiap subtree di-scan iteratif, jadi
+ * kedalaman rekursi hanya forkDepth dan jumlah thread paling banyak
+ * 2^forkDepth.
+ *
+ * @param root      Pointer ke root node dari BST
+ * @param forkDepth Jumlah level yang dipecah menjadi task paralel
+ * @return TreeStats Tinggi dan jumlah daun
+ */
+TreeStats parallelScanTree(Node* root, int forkDepth) {
+    if (root == nullptr || forkDepth <= 0) {
+        return scanTree(root);
+    }
+    if (root->left == nullptr && root->right == nullptr) {
+        return {0, 1};
+    }
+    std::future<TreeStats> leftTask = std::async(std::launch::async, parallelScanTree, root->left, forkDepth - 1);
+    TreeStats right = parallelScanTree(root->right, forkDepth - 1);
+    TreeStats left = leftTask.get();
+    return {std::max(left.height, right.height) + 1, left.leaves + right.leaves};
+}
+
+/**
+ * @brief Menghitung tinggi/kedalaman maksimum dari BST
+ *
+ * Fungsi ini menghitung tinggi/kedalaman maksimum dari BST, yang
+ * didefinisikan sebagai jumlah maksimum edge dari root ke daun.
+ * Tree kosong memiliki tinggi -1, sedangkan tree dengan hanya root
+ * memiliki tinggi 0.
+ *
+ * @param root Pointer ke root node dari BST atau sub-tree
+ * @return int Tinggi dari BST
+ *
+ * Contoh:
+ *     Untuk BST:      10
+ *                   /    \
+ *                  5     15
+ *                 / \    / \
+ *                3   7  12  20
+ *
+ *     height(root) akan mengembalikan 2
+ */
+int height(Node* root) {
+    // Tinggi tree adalah kedalaman node terdalam (scan iteratif)
+    return scanTree(root).height;
+}
+
+/**
+ * @brief Menghitung jumlah node daun (leaf) dalam BST
+ *
+ * Fungsi ini menghitung jumlah node daun dalam BST.
+ * Leaf adalah node yang tidak memiliki anak kiri dan anak kanan.
+ *
+ * @param root Pointer ke root node dari BST atau sub-tree
+ * @return int Jumlah leaf node dalam BST
+ *
+ * Contoh:
+ *     Untuk BST:      10
+ *                   /    \
+ *                  5     15
+ *                 / \    / \
+ *                3   7  12  20
+ *
+ *     countLeaves(root) akan mengembalikan 4 (node 3, 7, 12, dan 20 adalah leaf)
+ */
+int countLeaves(Node* root) {
+    // Leaf dihitung sambil scan iteratif seluruh tree
+    return (int)scanTree(root).leaves;
+}
+
+/**
+ * @brief Membebaskan seluruh node dalam BST
+ *
+ * Menggunakan stack eksplisit sehingga tree yang sangat dalam (misalnya
+ * hasil insert data terurut) tidak membuat stack overflow.
+ *
+ * @param root Pointer ke root node dari BST
+ */
+void destroyTree(Node* root) {
+    std::vector<Node*> stack;
+    if (root != nullptr) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (node->left != nullptr) {
+            stack.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            stack.push_back(node->right);
+        }
+        delete node;
+    }
+}
+
+/**
+ * @brief Pool allocator untuk node tree
+ *
+ * Node diambil dari blok besar (BLOCK_SIZE node per blok), bukan dari
+ * new per node. Node yang dihapus masuk free list untuk dipakai ulang,
+ * dan seluruh blok dibebaskan sekaligus dengan releaseAll().
+ */
+template <typename T>
+class NodePool {
+private:
+    static const size_t BLOCK_SIZE = 4096;
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    std::vector<std::unique_ptr<Storage[]>> blocks;
+    size_t usedInLastBlock = BLOCK_SIZE;
+    std::vector<T*> freeList;
+
+public:
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* memory;
+        if (!freeList.empty()) {
+            memory = freeList.back();
+            freeList.pop_back();
+        } else {
+            if (usedInLastBlock == BLOCK_SIZE) {
+                blocks.emplace_back(new Storage[BLOCK_SIZE]);
+                usedInLastBlock = 0;
+            }
+            memory = &blocks.back()[usedInLastBlock++];
+        }
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        freeList.push_back(object);
+    }
+
+    // Membebaskan semua blok; destructor objek yang masih hidup harus
+    // sudah dipanggil oleh pemilik pool jika T tidak trivially destructible
+    void releaseAll() {
+        blocks.clear();
+        freeList.clear();
+        usedInLastBlock = BLOCK_SIZE;
+    }
+};
+
+/**
+ * @brief Ordered map seimbang berbasis AVL tree
+ *
+ * Mendukung insert, erase, find dan lowerBound dalam O(log n). Tinggi
+ * setiap subtree dijaga selisihnya paling banyak 1, sehingga input terurut
+ * tidak lagi membuat tree menjadi linked list. Insert dan erase berjalan
+ * iteratif dengan menyimpan jalur link dari root ke node yang diubah.
+ *
+ * Konvensi tinggi sama dengan fungsi height(): node daun = 0, kosong = -1.
+ */
+template <typename Key, typename Value>
+class AVLMap {
+public:
+    struct AVLNode {
+        Key key;
+        Value value;
+        AVLNode* left = nullptr;
+        AVLNode* right = nullptr;
+        int height = 0;
+        size_t size = 1;   // jumlah node di subtree ini
+        size_t leaves = 1; // jumlah daun di subtree ini
+
+        AVLNode(const Key& k, const Value& v) : key(k), value(v) {}
+    };
+
+private:
+    // Tinggi AVL <= 1.44 log2(n + 2), 96 cukup untuk ukuran apa pun di memori
+    static const int MAX_PATH = 96;
+
+    NodePool<AVLNode> pool;
+    AVLNode* root = nullptr;
+    size_t count = 0;
+
+    static int heightOf(const AVLNode* node) { return node ? node->height : -1; }
+    static size_t sizeOf(const AVLNode* node) { return node ? node->size : 0; }
+    static size_t leavesOf(const AVLNode* node) { return node ? node->leaves : 0; }
+
+    // Menghitung ulang augmentasi node dari kedua anaknya dalam O(1)
+    static void updateNode(AVLNode* node) {
+        node->height = std::max(heightOf(node->left), heightOf(node->right)) + 1;
+        node->size = sizeOf(node->left) + sizeOf(node->right) + 1;
+        bool isLeaf = node->left == nullptr && node->right == nullptr;
+        node->leaves = isLeaf ? 1 : leavesOf(node->left) + leavesOf(node->right);
+    }
+
+    static void rotateRight(AVLNode*& node) {
+        AVLNode* pivot = node->left;
+        node->left = pivot->right;
+        pivot->right = node;
+        updateNode(node);
+        updateNode(pivot);
+        node = pivot;
+    }
+
+    static void rotateLeft(AVLNode*& node) {
+        AVLNode* pivot = node->right;
+        node->right = pivot->left;
+        pivot->left = node;
+        updateNode(node);
+        updateNode(pivot);
+        node = pivot;
+    }
+
+    // Menyeimbangkan subtree yang ditunjuk link
+    static void rebalance(AVLNode*& node) {
+        updateNode(node);
+        int balance = heightOf(node->left) - heightOf(node->right);
+        if (balance > 1) {
+            if (heightOf(node->left->left) < heightOf(node->left->right)) {
+                rotateLeft(node->left);
+            }
+            rotateRight(node);
+        } else if (balance < -1) {
+            if (heightOf(node->right->right) < heightOf(node->right->left)) {
+                rotateRight(node->right);
+            }
+            rotateLeft(node);
+        }
+    }
+
+    // Naik dari node terdalam ke root sambil menyeimbangkan ulang.
+    // Seluruh jalur selalu diproses karena size/leaves setiap ancestor berubah.
+    static void rebalancePath(AVLNode** path[], int depth) {
+        while (depth > 0) {
+            rebalance(*path[--depth]);
+        }
+    }
+
+public:
+    AVLMap() = default;
+    AVLMap(const AVLMap&) = delete;
+    AVLMap& operator=(const AVLMap&) = delete;
+    ~AVLMap() { clear(); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int height() const { return heightOf(root); }
+    size_t leafCount() const { return leavesOf(root); }
+    const AVLNode* getRoot() const { return root; }
+
+    // Menambahkan pasangan key/value; false jika key sudah ada
+    bool insert(const Key& key, const Value& value) {
+        AVLNode** path[MAX_PATH];
+        int depth = 0;
+        AVLNode** link = &root;
+        while (*link != nullptr) {
+            path[depth++] = link;
+            if (key < (*link)->key) {
+                link = &(*link)->left;
+            } else if ((*link)->key < key) {
+                link = &(*link)->right;
+            } else {
+                return false;
+            }
+        }
+        *link = pool.create(key, value);
+        count++;
+        rebalancePath(path, depth);
+        return true;
+    }
+
+    // Menghapus key; false jika key tidak ditemukan
+    bool erase(const Key& key) {
+        AVLNode** path[MAX_PATH];
+        int depth = 0;
+        AVLNode** link = &root;
+        while (*link != nullptr && ((*link)->key < key || key < (*link)->key)) {
+            path[depth++] = link;
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        AVLNode* node = *link;
+        if (node == nullptr) {
+            return false;
+        }
+
+        if (node->left != nullptr && node->right != nullptr) {
+            // Ganti isi node dengan successor, lalu hapus node successor
+            path[depth++] = link;
+            AVLNode** successorLink = &node->right;
+            while ((*successorLink)->left != nullptr) {
+                path[depth++] = successorLink;
+                successorLink = &(*successorLink)->left;
+            }
+            AVLNode* successor = *successorLink;
+            node->key = std::move(successor->key);
+            node->value = std::move(successor->value);
+            *successorLink = successor->right;
+            pool.destroy(successor);
+        } else {
+            *link = node->left != nullptr ? node->left : node->right;
+            pool.destroy(node);
+        }
+        count--;
+        rebalancePath(path, depth);
+        return true;
+    }
+
+    // Pointer ke value untuk key, nullptr jika tidak ada
+    Value* find(const Key& key) {
+        AVLNode* node = root;
+        while (node != nullptr) {
+            if (key < node->key) {
+                node = node->left;
+            } else if (node->key < key) {
+                node = node->right;
+            } else {
+                return &node->value;
+            }
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) { return find(key) != nullptr; }
+
+    // Node dengan key terkecil yang >= key, nullptr jika tidak ada
+    const AVLNode* lowerBound(const Key& key) const {
+        const AVLNode* node = root;
+        const AVLNode* best = nullptr;
+        while (node != nullptr) {
+            if (node->key < key) {
+                node = node->right;
+            } else {
+                best = node;
+                node = node->left;
+            }
+        }
+        return best;
+    }
+
+    // Jumlah key yang lebih kecil dari key (O(log n))
+    size_t rank(const Key& key) const {
+        size_t result = 0;
+        const AVLNode* node = root;
+        while (node != nullptr) {
+            if (node->key < key) {
+                result += sizeOf(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return result;
+    }
+
+    // Node dengan key terkecil ke-k (mulai dari 0), nullptr jika k >= size()
+    const AVLNode* select(size_t k) const {
+        const AVLNode* node = root;
+        while (node != nullptr) {
+            size_t leftSize = sizeOf(node->left);
+            if (k < leftSize) {
+                node = node->left;
+            } else if (k == leftSize) {
+                return node;
+            } else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+        return nullptr;
+    }
+
+    // Membebaskan semua node sekaligus lewat pool
+    void clear() {
+        if (!std::is_trivially_destructible<AVLNode>::value) {
+            std::vector<AVLNode*> stack;
+            if (root != nullptr) {
+                stack.push_back(root);
+            }
+            while (!stack.empty()) {
+                AVLNode* node = stack.back();
+                stack.pop_back();
+                if (node->left != nullptr) {
+                    stack.push_back(node->left);
+                }
+                if (node->right != nullptr) {
+                    stack.push_back(node->right);
+                }
+                node->~AVLNode();
+            }
+        }
+        pool.releaseAll();
+        root = nullptr;
+        count = 0;
+    }
+};
+
+// Ordered set: AVLMap tanpa value
+struct NoValue {};
+
+template <typename Key>
+using AVLSet = AVLMap<Key, NoValue>;
+
+/**
+ * @brief Struktur pencarian statis dengan layout Eytzinger
+ *
+ * Key terurut disimpan dalam satu array dengan urutan BFS dari complete
+ * binary tree implisit: anak dari indeks k ada di 2k dan 2k+1 (indeks 1-based).
+ * Tidak ada pointer yang dikejar; level atas tree berbagi cache line dan
+ * pencarian bersifat branchless sehingga cabang tidak salah prediksi.
+ * Cocok untuk tabel lookup yang dibangun sekali lalu hanya dibaca.
+ */
+// Posisi bit 1 terendah dan tertinggi (0 = LSB); x tidak boleh 0
+inline int lowestSetBit(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+#else
+    int b = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+inline int highestSetBit(uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (int)index;
+#else
+    int b = 0;
+    while (x >>= 1) {
+        b++;
+    }
+    return b;
+#endif
+}
+
+class EytzingerTree {
+private:
+    std::vector<int> keys; // keys[0] tidak dipakai, tree ada di keys[1..n]
+    size_t n;
+
+    // Mengisi keys secara in-order dari array terurut (kedalaman rekursi log n)
+    size_t build(const std::vector<int>& sorted, size_t i, size_t k) {
+        if (k <= n) {
+            i = build(sorted, i, 2 * k);
+            keys[k] = sorted[i++];
+            i = build(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // Mengubah posisi akhir pencarian menjadi indeks lower bound (0 = tidak ada)
+    static size_t resolve(size_t k) {
+        return k >> (lowestSetBit(~(uint64_t)k) + 1);
+    }
+
+public:
+    // Membangun dari key yang sudah terurut dan unik
+    explicit EytzingerTree(const std::vector<int>& sorted) : keys(sorted.size() + 1), n(sorted.size()) {
+        build(sorted, 0, 1);
+    }
+
+    // Membangun dari BST biasa lewat traversal in-order iteratif
+    static EytzingerTree fromBST(Node* root) {
+        std::vector<int> sorted;
+        std::vector<Node*> stack;
+        Node* node = root;
+        while (node != nullptr || !stack.empty()) {
+            while (node != nullptr) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            sorted.push_back(node->data);
+            node = node->right;
+        }
+        return EytzingerTree(sorted);
+    }
+
+    size_t size() const { return n; }
+
+    // Key terkecil yang >= key, nullptr jika tidak ada
+    const int* lowerBound(int key) const {
+        const int* base = keys.data();
+        size_t k = 1;
+        while (k <= n) {
+            // 16 int = satu cache line; ambil cucu keempat lebih awal selama
+            // masih di dalam array (pointer di luar array tidak boleh dibentuk)
+            if (16 * k <= n) {
+                BST_PREFETCH(base + 16 * k);
+            }
+            k = 2 * k + (base[k] < key);
+        }
+        k = resolve(k);
+        return k == 0 ? nullptr : base + k;
+    }
+
+    bool contains(int key) const {
+        const int* found = lowerBound(key);
+        return found != nullptr && *found == key;
+    }
+
+    /**
+     * @brief lowerBound untuk banyak key sekaligus
+     *
+     * Key diproses dalam kelompok BATCH yang turun level demi level secara
+     * bersamaan, dan setiap langkah mem-prefetch node berikutnya. Selama
+     * satu key menunggu memori, key lain di kelompok yang sama tetap
+     * berjalan, sehingga latensi cache miss saling tumpang tindih.
+     *
+     * @param queries Key yang dicari
+     * @param count   Jumlah key
+     * @param results results[i] = lowerBound(queries[i])
+     */
+    void lowerBoundBatch(const int* queries, size_t count, const int** results) const {
+        const size_t BATCH = 16;
+        const int* base = keys.data();
+        int levels = n == 0 ? 0 : highestSetBit(n) + 1; // jumlah level tree implisit
+        size_t k[BATCH];
+
+        for (size_t start = 0; start < count; start += BATCH) {
+            size_t m = std::min(BATCH, count - start);
+            for (size_t j = 0; j < m; j++) {
+                k[j] = 1;
+            }
+            for (int level = 0; level < levels; level++) {
+                for (size_t j = 0; j < m; j++) {
+                    // Di level terakhir sebagian posisi sudah melewati n
+                    size_t cur = k[j];
+                    size_t safe = cur <= n ? cur : 0;
+                    size_t next = 2 * cur + (base[safe] < queries[start + j]);
+                    k[j] = cur <= n ? next : cur;
+                    BST_PREFETCH(base + (k[j] <= n ? k[j] : 0));
+                }
+            }
+            for (size_t j = 0; j < m; j++) {
+                size_t pos = resolve(k[j]);
+                results[start + j] = pos == 0 ? nullptr : base + pos;
+            }
+        }
+    }
+
+    // Nilai terkecil: node paling kiri dari tree implisit
+    const int* minKey() const {
+        if (n == 0) {
+            return nullptr;
+        }
+        size_t k = 1;
+        while (2 * k <= n) {
+            k = 2 * k;
+        }
+        return keys.data() + k;
+    }
+
+    // Nilai terbesar: node paling kanan dari tree implisit
+    const int* maxKey() const {
+        if (n == 0) {
+            return nullptr;
+        }
+        size_t k = 1;
+        while (2 * k + 1 <= n) {
+            k = 2 * k + 1;
+        }
+        return keys.data() + k;
+    }
+
+    // Tinggi complete binary tree: floor(log2 n), -1 jika kosong
+    int height() const {
+        return n == 0 ? -1 : highestSetBit(n);
+    }
+
+    // Node k adalah daun jika 2k > n, jadi daun = n - floor(n / 2)
+    int countLeaves() const {
+        return (int)(n - n / 2);
+    }
+};
+
+// Versi findMin/findMax/height/countLeaves untuk EytzingerTree,
+// sehingga kode yang memakai fungsi BST di atas bisa langsung beralih
+
+const int* findMin(const EytzingerTree& tree) {
+    return tree.minKey();
+}
+
+const int* findMax(const EytzingerTree& tree) {
+    return tree.maxKey();
+}
+
+int height(const EytzingerTree& tree) {
+    return tree.height();
+}
+
+int countLeaves(const EytzingerTree& tree) {
+    return tree.countLeaves();
+}
+
+/**
+ * @brief Epoch-based reclamation (EBR) untuk struktur data konkuren
+ *
+ * Node yang sudah dilepas dari struktur tidak langsung di-delete karena
+ * reader lain mungkin masih memegang pointer ke node tersebut. Node
+ * "dipensiunkan" bersama epoch global saat itu dan baru dibebaskan
+ * setelah epoch global maju dua kali, yaitu ketika semua thread yang
+ * aktif dijamin sudah keluar dari critical section lama.
+ */
+class EpochManager {
+private:
+    static const int MAX_THREADS = 256;
+    static const size_t RETIRE_THRESHOLD = 128;
+
+    struct RetiredNode {
+        void* pointer;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    struct alignas(64) ThreadRecord {
+        std::atomic<bool> inUse{false};
+        std::atomic<bool> active{false};
+        std::atomic<uint64_t> epoch{0};
+        int nesting = 0;
+        std::vector<RetiredNode> retired; // hanya diakses thread pemilik record
+    };
+
+    std::atomic<uint64_t> globalEpoch{2};
+    ThreadRecord records[MAX_THREADS];
+
+    // Record milik thread ini; dilepas (beserta sisa node) saat thread selesai.
+    // Melempar std::length_error jika MAX_THREADS record sudah dipakai thread lain
+    ThreadRecord& localRecord() {
+        struct Registration {
+            ThreadRecord* record = nullptr;
+            ~Registration() {
+                if (record != nullptr) {
+                    record->inUse.store(false);
+                }
+            }
+        };
+        thread_local Registration registration;
+        if (registration.record == nullptr) {
+            for (int i = 0; i < MAX_THREADS && registration.record == nullptr; i++) {
+                bool expected = false;
+                if (records[i].inUse.compare_exchange_strong(expected, true)) {
+                    registration.record = &records[i];
+                }
+            }
+            if (registration.record == nullptr) {
+                throw std::length_error("EpochManager: lebih dari " + std::to_string(MAX_THREADS) +
+                                        " thread memakai struktur konkuren sekaligus");
+            }
+        }
+        return *registration.record;
+    }
+
+    // Memajukan epoch jika semua thread aktif sudah berada di epoch terbaru
+    void tryAdvance() {
+        uint64_t current = globalEpoch.load();
+        for (ThreadRecord& record : records) {
+            if (record.active.load() && record.epoch.load() != current) {
+                return;
+            }
+        }
+        globalEpoch.compare_exchange_strong(current, current + 1);
+    }
+
+    static void freeExpired(ThreadRecord& record, uint64_t safeEpoch) {
+        size_t kept = 0;
+        for (RetiredNode& node : record.retired) {
+            if (node.epoch <= safeEpoch) {
+                node.deleter(node.pointer);
+            } else {
+                record.retired[kept++] = node;
+            }
+        }
+        record.retired.resize(kept);
+    }
+
+public:
+    static EpochManager& instance() {
+        static EpochManager manager;
+        return manager;
+    }
+
+    ~EpochManager() { drainAll(); }
+
+    void enter() {
+        ThreadRecord& record = localRecord();
+        if (record.nesting++ == 0) {
+            record.active.store(true);
+            record.epoch.store(globalEpoch.load());
+        }
+    }
+
+    void exit() {
+        ThreadRecord& record = localRecord();
+        if (--record.nesting == 0) {
+            record.active.store(false);
+        }
+    }
+
+    template <typename T>
+    void retire(T* pointer) {
+        ThreadRecord& record = localRecord();
+        record.retired.push_back({pointer, [](void* p) { delete static_cast<T*>(p); }, globalEpoch.load()});
+        if (record.retired.size() >= RETIRE_THRESHOLD) {
+            tryAdvance();
+            freeExpired(record, globalEpoch.load() - 2);
+        }
+    }
+
+    // Membebaskan semua node yang tersisa; hanya aman jika tidak ada thread aktif
+    void drainAll() {
+        for (ThreadRecord& record : records) {
+            freeExpired(record, UINT64_MAX);
+        }
+    }
+};
+
+// Critical section EBR: pointer yang dibaca di dalam guard tidak akan dibebaskan
+class EpochGuard {
+public:
+    EpochGuard() { EpochManager::instance().enter(); }
+    ~EpochGuard() { EpochManager::instance().exit(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+/**
+ * @brief Ordered map konkuren berbasis BST eksternal (leaf-oriented)
+ *
+ * Key dan value disimpan di daun; node internal hanya sebagai penunjuk
+ * arah. Dua daun sentinel (tak hingga) menjamin setiap daun asli punya
+ * parent dan grandparent.
+ *
+ * - find/contains: lock-free, hanya membaca pointer anak secara atomik.
+ * - insert: mengunci parent, memvalidasi parent masih terhubung ke daun
+ *   yang ditemukan, lalu mengganti daun dengan node internal baru.
+ * - erase: mengunci grandparent lalu parent (urutan atas ke bawah,
+ *   bebas deadlock), memvalidasi, lalu menyambung grandparent ke sibling.
+ *   Parent dan daun yang terlepas dibebaskan lewat EpochManager.
+ * Jika validasi gagal karena ada writer lain, operasi diulang.
+ */
+template <typename Key, typename Value>
+class ConcurrentBSTMap {
+private:
+    struct CNode {
+        Key key;
+        Value value;
+        int infinity; // 0 = key biasa, 1 dan 2 = sentinel (lebih besar dari semua key)
+        bool leaf;
+        std::atomic<CNode*> left{nullptr};
+        std::atomic<CNode*> right{nullptr};
+        std::atomic<bool> removed{false};
+        std::mutex lock;
+
+        CNode(const Key& k, const Value& v, int inf, bool isLeaf) : key(k), value(v), infinity(inf), leaf(isLeaf) {}
+    };
+
+    CNode* root;
+
+    // true jika key diarahkan ke anak kiri node
+    static bool goesLeft(const Key& key, const CNode* node) {
+        return node->infinity > 0 || key < node->key;
+    }
+
+    static bool matches(const Key& key, const CNode* leaf) {
+        return leaf->infinity == 0 && !(key < leaf->key) && !(leaf->key < key);
+    }
+
+    static std::atomic<CNode*>& childToward(const Key& key, CNode* node) {
+        return goesLeft(key, node) ? node->left : node->right;
+    }
+
+    // Turun dari root sampai daun; harus dipanggil di dalam EpochGuard
+    void search(const Key& key, CNode*& grandparent, CNode*& parent, CNode*& leaf) const {
+        grandparent = nullptr;
+        parent = root;
+        leaf = childToward(key, root).load(std::memory_order_acquire);
+        while (!leaf->leaf) {
+            grandparent = parent;
+            parent = leaf;
+            leaf = childToward(key, leaf).load(std::memory_order_acquire);
+        }
+    }
+
+public:
+    ConcurrentBSTMap() {
+        root = new CNode(Key(), Value(), 2, false);
+        root->left.store(new CNode(Key(), Value(), 1, true));
+        root->right.store(new CNode(Key(), Value(), 2, true));
+    }
+
+    ConcurrentBSTMap(const ConcurrentBSTMap&) = delete;
+    ConcurrentBSTMap& operator=(const ConcurrentBSTMap&) = delete;
+
+    // Hanya boleh dipanggil setelah semua thread selesai memakai map
+    ~ConcurrentBSTMap() {
+        std::vector<CNode*> stack{root};
+        while (!stack.empty()) {
+            CNode* node = stack.back();
+            stack.pop_back();
+            if (!node->leaf) {
+                stack.push_back(node->left.load());
+                stack.push_back(node->right.load());
+            }
+            delete node;
+        }
+    }
+
+    // Lock-free; mengisi value jika key ditemukan
+    bool find(const Key& key, Value& value) const {
+        EpochGuard guard;
+        CNode *grandparent, *parent, *leaf;
+        search(key, grandparent, parent, leaf);
+        if (!matches(key, leaf)) {
+            return false;
+        }
+        value = leaf->value;
+        return true;
+    }
+
+    bool contains(const Key& key) const {
+        EpochGuard guard;
+        CNode *grandparent, *parent, *leaf;
+        search(key, grandparent, parent, leaf);
+        return matches(key, leaf);
+    }
+
+    // false jika key sudah ada
+    bool insert(const Key& key, const Value& value) {
+        while (true) {
+            EpochGuard guard;
+            CNode *grandparent, *parent, *leaf;
+            search(key, grandparent, parent, leaf);
+            if (matches(key, leaf)) {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> parentLock(parent->lock);
+            std::atomic<CNode*>& link = childToward(key, parent);
+            if (parent->removed.load() || link.load() != leaf) {
+                continue; // Ada writer lain di antara search dan lock
+            }
+
+            CNode* newLeaf = new CNode(key, value, 0, true);
+            CNode* internal;
+            if (goesLeft(key, leaf)) {
+                internal = new CNode(leaf->key, Value(), leaf->infinity, false);
+                internal->left.store(newLeaf, std::memory_order_relaxed);
+                internal->right.store(leaf, std::memory_order_relaxed);
+            } else {
+                internal = new CNode(key, Value(), 0, false);
+                internal->left.store(leaf, std::memory_order_relaxed);
+                internal->right.store(newLeaf, std::memory_order_relaxed);
+            }
+            link.store(internal, std::memory_order_release);
+            return true;
+        }
+    }
+
+    // false jika key tidak ditemukan
+    bool erase(const Key& key) {
+        while (true) {
+            EpochGuard guard;
+            CNode *grandparent, *parent, *leaf;
+            search(key, grandparent, parent, leaf);
+            if (!matches(key, leaf)) {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> grandparentLock(grandparent->lock);
+            std::lock_guard<std::mutex> parentLock(parent->lock);
+            std::atomic<CNode*>& link = childToward(key, grandparent);
+            std::atomic<CNode*>& leafLink = childToward(key, parent);
+            if (grandparent->removed.load() || parent->removed.load() ||
+                link.load() != parent || leafLink.load() != leaf) {
+                continue;
+            }
+
+            CNode* sibling = (&leafLink == &parent->left) ? parent->right.load() : parent->left.load();
+            link.store(sibling, std::memory_order_release);
+            parent->removed.store(true);
+            EpochManager::instance().retire(parent);
+            EpochManager::instance().retire(leaf);
+            return true;
+        }
+    }
+};
+
+// Fungsi untuk membuat dan menampilkan tree sebagai contoh
+void testBSTFunctions() {
+    // Membuat BST seperti:
+    //         10
+    //       /    \
+    //      5     15
+    //     / \    / \
+    //    3   7  12  20
+
+    Node* root = new Node(10);
+    root->left = new Node(5);
+    root->right = new Node(15);
+    root->left->left = new Node(3);
+    root->left->right = new Node(7);
+    root->right->left = new Node(12);
+    root->right->right = new Node(20);
+
+    // Test findMin
+    Node* min = findMin(root);
+    std::cout << "Nilai terkecil: " << (min ? min->data : -1) << std::endl;
+
+    // Test findMax
+    Node* max = findMax(root);
+    std::cout << "Nilai terbesar: " << (max ? max->data : -1) << std::endl;
+
+    // Test height
+    std::cout << "Tinggi tree: " << height(root) << std::endl;
+
+    // Test countLeaves
+    std::cout << "Jumlah daun: " << countLeaves(root) << std::endl;
+
+    // Tabel lookup statis dari key yang sama
+    EytzingerTree table = EytzingerTree::fromBST(root);
+    std::cout << "Eytzinger - terkecil: " << *findMin(table) << ", terbesar: " << *findMax(table)
+              << ", tinggi: " << height(table) << ", daun: " << countLeaves(table) << std::endl;
+    const int* bound = table.lowerBound(11);
+    std::cout << "Eytzinger - lowerBound(11): " << (bound ? *bound : -1) << std::endl;
+
+    // Pembersihan memori (dealokasi)
+    destroyTree(root);
+}
+
+// Contoh penggunaan AVLMap
+void testAVLMap() {
+    AVLMap<int, std::string> map;
+    int keys[] = {10, 5, 15, 3, 7, 12, 20};
+    for (int key : keys) {
+        map.insert(key, "nilai-" + std::to_string(key));
+    }
+    std::cout << "AVLMap size: " << map.size() << ", tinggi: " << map.height() << std::endl;
+    std::cout << "find(7): " << *map.find(7) << std::endl;
+
+    const AVLMap<int, std::string>::AVLNode* bound = map.lowerBound(13);
+    std::cout << "lowerBound(13): " << (bound ? bound->key : -1) << std::endl;
+
+    map.erase(10);
+    map.erase(15);
+    std::cout << "Setelah erase 10 dan 15, find(10): " << (map.find(10) ? "ada" : "tidak ada")
+              << ", size: " << map.size() << std::endl;
+
+    // Insert terurut tetap seimbang
+    AVLSet<int> sorted;
+    for (int i = 0; i < 1000000; i++) {
+        sorted.insert(i, NoValue());
+    }
+    std::cout << "1.000.000 key terurut, tinggi AVL: " << sorted.height() << std::endl;
+
+    // Statistik O(1) dan order-statistic O(log n)
+    std::cout << "Daun: " << sorted.leafCount() << ", rank(500000): " << sorted.rank(500000)
+              << ", select(123456): " << sorted.select(123456)->key << std::endl;
+}
+
+// Benchmark statistik tree: scan iteratif, scan fork-join, dan augmentasi AVL
+void benchmarkTreeStats(size_t n) {
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = (int)i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+
+    // BST biasa (tanpa balancing) dari key acak
+    Node* root = nullptr;
+    AVLSet<int> avl;
+    for (int key : keys) {
+        Node** link = &root;
+        while (*link != nullptr) {
+            link = key < (*link)->data ? &(*link)->left : &(*link)->right;
+        }
+        *link = new Node(key);
+        avl.insert(key, NoValue());
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    TreeStats serial = scanTree(root);
+    auto t1 = std::chrono::steady_clock::now();
+    TreeStats parallel = parallelScanTree(root, 3);
+    auto t2 = std::chrono::steady_clock::now();
+    size_t leaves = avl.leafCount();
+    int avlHeight = avl.height();
+    size_t middle = avl.select(n / 2)->key;
+    auto t3 = std::chrono::steady_clock::now();
+
+    std::cout << "metode,n,tinggi,daun,waktu_us" << std::endl;
+    std::cout << "scan iteratif," << n << "," << serial.height << "," << serial.leaves << ","
+              << std::chrono::duration<double, std::micro>(t1 - t0).count() << std::endl;
+    std::cout << "scan fork-join," << n << "," << parallel.height << "," << parallel.leaves << ","
+              << std::chrono::duration<double, std::micro>(t2 - t1).count() << std::endl;
+    std::cout << "AVL augmentasi," << n << "," << avlHeight << "," << leaves << ","
+              << std::chrono::duration<double, std::micro>(t3 - t2).count() << " (median " << middle << ")"
+              << std::endl;
+
+    destroyTree(root);
+
+    // Tree terdegenerasi (input terurut) sedalam n tidak lagi membuat stack overflow
+    Node* chain = nullptr;
+    Node** tail = &chain;
+    for (size_t i = 0; i < n; i++) {
+        *tail = new Node((int)i);
+        tail = &(*tail)->right;
+    }
+    std::cout << "Tree rantai " << n << " node: tinggi " << height(chain) << ", daun " << countLeaves(chain)
+              << ", max " << findMax(chain)->data << std::endl;
+    destroyTree(chain);
+}
+
+// Benchmark AVLSet vs std::set untuk insert acak dan terurut lalu lookup
+void benchmarkOrderedSet(size_t n) {
+    std::vector<int> randomKeys(n);
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < n; i++) {
+        randomKeys[i] = (int)i;
+    }
+    std::shuffle(randomKeys.begin(), randomKeys.end(), rng);
+    std::vector<int> sortedKeys(randomKeys);
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    std::cout << "pola,n,struktur,insert_ms,lookup_ms" << std::endl;
+    const std::vector<int>* patterns[] = {&randomKeys, &sortedKeys};
+    const char* names[] = {"acak", "terurut"};
+    for (int p = 0; p < 2; p++) {
+        const std::vector<int>& keys = *patterns[p];
+        size_t found = 0;
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            std::set<int> set;
+            for (int key : keys) {
+                set.insert(key);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            for (int key : randomKeys) {
+                found += set.count(key);
+            }
+            auto t2 = std::chrono::steady_clock::now();
+            std::cout << names[p] << "," << n << ",std::set," << ms(t0, t1) << "," << ms(t1, t2) << std::endl;
+        }
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            AVLSet<int> set;
+            for (int key : keys) {
+                set.insert(key, NoValue());
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            for (int key : randomKeys) {
+                found += set.contains(key);
+            }
+            auto t2 = std::chrono::steady_clock::now();
+            std::cout << names[p] << "," << n << ",AVLSet," << ms(t0, t1) << "," << ms(t1, t2) << std::endl;
+        }
+        if (found != 2 * n) {
+            std::cout << "Hasil lookup tidak cocok!" << std::endl;
+        }
+    }
+}
+
+// Benchmark lookup: AVLSet (pointer) vs std::lower_bound vs Eytzinger
+void benchmarkStaticSearch(size_t n) {
+    std::vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = (int)(2 * i); // key genap, setengah query tidak ditemukan
+    }
+    const size_t queryCount = 1 << 22;
+    std::vector<int> queries(queryCount);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(0, (int)(2 * n));
+    for (auto& q : queries) {
+        q = dist(rng);
+    }
+
+    AVLSet<int> avl;
+    for (int key : sorted) {
+        avl.insert(key, NoValue());
+    }
+    EytzingerTree table(sorted);
+    std::vector<const int*> results(queryCount);
+
+    auto nsPerQuery = [queryCount](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / queryCount;
+    };
+    size_t checksum[4] = {0, 0, 0, 0};
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int q : queries) {
+        const AVLSet<int>::AVLNode* node = avl.lowerBound(q);
+        checksum[0] += node ? node->key : 0;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int q : queries) {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), q);
+        checksum[1] += it != sorted.end() ? *it : 0;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    for (int q : queries) {
+        const int* found = table.lowerBound(q);
+        checksum[2] += found ? *found : 0;
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    table.lowerBoundBatch(queries.data(), queryCount, results.data());
+    for (const int* found : results) {
+        checksum[3] += found ? *found : 0;
+    }
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::cout << "struktur,n,ns_per_lookup" << std::endl;
+    std::cout << "AVLSet," << n << "," << nsPerQuery(t0, t1) << std::endl;
+    std::cout << "std::lower_bound," << n << "," << nsPerQuery(t1, t2) << std::endl;
+    std::cout << "Eytzinger," << n << "," << nsPerQuery(t2, t3) << std::endl;
+    std::cout << "Eytzinger batch," << n << "," << nsPerQuery(t3, t4) << std::endl;
+    if (checksum[0] != checksum[1] || checksum[1] != checksum[2] || checksum[2] != checksum[3]) {
+        std::cout << "Hasil lookup tidak cocok!" << std::endl;
+    }
+}
+
+// Benchmark operasi/detik ConcurrentBSTMap untuk campuran baca/tulis dan jumlah thread
+void benchmarkConcurrentBST() {
+    const int keyRange = 1 << 18;
+    const int readPercents[] = {95, 50};
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    const auto duration = std::chrono::milliseconds(200);
+
+    std::cout << "baca_persen,thread,ops_per_detik" << std::endl;
+    for (int readPercent : readPercents) {
+        for (int threads : threadCounts) {
+            ConcurrentBSTMap<int, int> map;
+            std::mt19937 seed(1);
+            for (int i = 0; i < keyRange / 2; i++) {
+                int key = (int)(seed() % keyRange);
+                map.insert(key, key);
+            }
+
+            std::atomic<bool> stop(false);
+            std::atomic<long long> totalOps(0);
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    std::mt19937 rng(100 + t);
+                    long long ops = 0;
+                    int value;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        int key = (int)(rng() % keyRange);
+                        int dice = (int)(rng() % 100);
+                        if (dice < readPercent) {
+                            map.find(key, value);
+                        } else if (dice % 2 == 0) {
+                            map.insert(key, key);
+                        } else {
+                            map.erase(key);
+                        }
+                        ops++;
+                    }
+                    totalOps += ops;
+                });
+            }
+            std::this_thread::sleep_for(duration);
+            stop = true;
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            double seconds = std::chrono::duration<double>(duration).count();
+            std::cout << readPercent << "," << threads << "," << (long long)(totalOps / seconds) << std::endl;
+        }
+    }
+    EpochManager::instance().drainAll();
+}
+
+int main(int argc, char* argv[]) {
+    testBSTFunctions();
+    testAVLMap();
+
+    // Jumlah key benchmark bisa diatur, misalnya: ./bst 10000000 16777216
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    benchmarkOrderedSet(n);
+    benchmarkTreeStats(n);
+
+    // Tabel default 8M key (32 MB), lebih besar dari cache L3 umumnya
+    size_t tableSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : (1 << 23);
+    benchmarkStaticSearch(tableSize);
+
+    benchmarkConcurrentBST();
+    return 0;
+}
@@ -1,10 +1,146 @@
-### Struktur Class `Graph`
+// ### Struktur Class `Graph`
 
 #include <iostream>
 #include <vector>
 #include <queue>
 #include <list>
 #include <map> // Untuk representasi adjacency list dengan nama node
+#include <string>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Indexed d-ary min-heap untuk Dijkstra/A*.
+// Menyimpan id vertex dengan key-nya dan mendukung decrease-key lewat
+// tabel posisi, sehingga tidak ada entri duplikat seperti priority_queue.
+template <int D>
+class IndexedDaryHeap {
+private:
+    std::vector<int> heap;     // id vertex dalam urutan heap
+    std::vector<int> position; // posisi id di heap, -1 jika tidak ada
+    std::vector<double> key;   // key per id vertex
+
+    void place(int i, int id) {
+        heap[i] = id;
+        position[id] = i;
+    }
+
+    void siftUp(int i) {
+        int id = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (key[heap[parent]] <= key[id]) {
+                break;
+            }
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, id);
+    }
+
+    void siftDown(int i) {
+        int id = heap[i];
+        int size = (int)heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= size) {
+                break;
+            }
+            int best = first;
+            int last = std::min(first + D, size);
+            for (int c = first + 1; c < last; c++) {
+                if (key[heap[c]] < key[heap[best]]) {
+                    best = c;
+                }
+            }
+            if (key[heap[best]] >= key[id]) {
+                break;
+            }
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, id);
+    }
+
+public:
+    explicit IndexedDaryHeap(int n = 0) : position(n, -1), key(n, 0) {}
+
+    bool empty() const { return heap.empty(); }
+
+    // Menambahkan id atau menurunkan key-nya jika sudah ada di heap
+    void pushOrDecrease(int id, double k) {
+        key[id] = k;
+        if (position[id] == -1) {
+            heap.push_back(id);
+            siftUp((int)heap.size() - 1);
+        } else {
+            siftUp(position[id]);
+        }
+    }
+
+    int popMin() {
+        int top = heap[0];
+        position[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+    void clear() {
+        for (int id : heap) {
+            position[id] = -1;
+        }
+        heap.clear();
+    }
+};
+
+// Ruang kerja pencarian jalur terpendek yang bisa dipakai ulang antar query.
+// Hanya vertex yang tersentuh yang di-reset, bukan seluruh array.
+struct ShortestPathWorkspace {
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> touched;
+    IndexedDaryHeap<4> heap;
+
+    explicit ShortestPathWorkspace(int n)
+        : dist(n, std::numeric_limits<double>::infinity()), parent(n, -1), heap(n) {}
+
+    void reset() {
+        for (int v : touched) {
+            dist[v] = std::numeric_limits<double>::infinity();
+            parent[v] = -1;
+        }
+        touched.clear();
+        heap.clear();
+    }
+};
 
 class Graph {
 private:
@@ -16,9 +152,37 @@ private:
     // Representasi Adjacency List
     // Menggunakan map untuk memetakan nama node ke daftar tetangga
     std::map<std::string, std::list<std::string>> adjList;
+    // Bobot edge, sejajar dengan urutan tetangga di adjList
+    std::map<std::string, std::list<double>> adjWeight;
+
+    // Pemetaan nama node <-> id integer (dipakai traversal cepat)
+    std::map<std::string, int> vertexId;
+    std::vector<std::string> vertexName;
+
+    // Representasi CSR (Compressed Sparse Row) dari adjacency list.
+    // Edge keluar: tetangga u ada di csrTarget[csrOffset[u] .. csrOffset[u+1])
+    // Edge masuk dipakai langkah bottom-up pada BFS paralel.
+    std::vector<int> csrOffset, csrTarget;
+    std::vector<double> csrWeight;
+    std::vector<int> csrInOffset, csrInSource;
+    std::vector<double> csrInWeight; // bobot edge masuk, untuk pencarian mundur
+    bool csrDirty; // true jika adjList berubah sejak CSR terakhir dibangun
+    bool adjListStale; // true jika edge hanya ada di CSR (setelah loadEdges)
+
+    int internVertex(const std::string& name);
+    void buildCSR();
+    void materializeAdjList();
 
-    // Helper untuk DFS
-    void DFSUtil(std::string vertex, std::map<std::string, bool>& visited, std::vector<std::string>& result);
+    // Helper untuk DFS iteratif dengan stack eksplisit dan bitset visited
+    template <typename Visitor>
+    void DFSFrom(int start, std::vector<uint64_t>& visited, Visitor& visitor);
+
+    // Inti Dijkstra/A*: menetapkan vertex berurutan menurut dist + h(v)
+    // sampai stop(u) bernilai true atau heap kosong. backward = true berjalan
+    // lewat edge masuk, jadi dist[v] = jarak v -> src
+    template <typename Heuristic, typename StopCondition>
+    void searchShortestPath(int src, Heuristic h, StopCondition stop, ShortestPathWorkspace& ws,
+                            bool backward = false);
 
 public:
     // Konstruktor
@@ -28,13 +192,2137 @@ public:
     // Fungsi addEdge()
     void addEdgeMatrix(int src, int dest);
     void addEdgeList(std::string src, std::string dest);
+    void addEdgeList(std::string src, std::string dest, double weight); // edge berbobot
+    bool removeEdgeList(std::string src, std::string dest); // hapus satu edge src -> dest
+    // Mengganti isi graf dengan edge berid integer 0..vertexCount-1 langsung ke
+    // CSR (nama vertex = id desimal). weights kosong berarti bobot 1.
+    void loadEdges(int vertexCount, const std::vector<std::pair<int, int>>& edges,
+                   const std::vector<double>& weights = {});
 
     // Fungsi Traversal
     std::vector<int> BFSMatrix(int startVertex);
     std::vector<std::string> BFSList(std::string startVertex);
     std::vector<std::string> DFSList(std::string startVertex);
 
+    // BFS yang mengembalikan level (jarak dalam jumlah edge) per id vertex,
+    // -1 untuk vertex yang tidak terjangkau
+    std::vector<int> BFSLevels(std::string startVertex);
+    // BFS paralel direction-optimizing (top-down / bottom-up), hasil sama dengan BFSLevels
+    std::vector<int> parallelBFSLevels(std::string startVertex, int numThreads = 0);
+
+    // DFS iteratif yang mengalirkan vertex ke visitor saat ditemukan.
+    // Visitor harus punya method preVisit(int id) dan postVisit(int id).
+    template <typename Visitor>
+    void DFSVisit(std::string startVertex, Visitor& visitor);
+
+    // Urutan topologis; mengembalikan false jika graf memiliki siklus
+    bool topologicalSort(std::vector<std::string>& order);
+    // Strongly connected components (Tarjan iteratif).
+    // componentOf[id] berisi nomor komponen, nilai kembali = jumlah komponen
+    int stronglyConnectedComponents(std::vector<int>& componentOf);
+
+    // Jarak terpendek dari source ke semua vertex (Dijkstra, heap 4-ary).
+    // Indeks = id vertex, infinity untuk vertex yang tidak terjangkau.
+    std::vector<double> dijkstra(std::string source);
+    // A* dengan heuristic h(id) -> perkiraan jarak ke target (harus admissible).
+    // Mengembalikan jarak, path diisi nama vertex dari source ke target.
+    template <typename Heuristic>
+    double aStar(std::string source, std::string target, Heuristic h, std::vector<std::string>* path = nullptr);
+    // Query jarak many-to-many berbasis bucket: hasil[i][j] = jarak sources[i] -> targets[j]
+    std::vector<std::vector<double>> distanceMatrix(const std::vector<std::string>& sources,
+                                                    const std::vector<std::string>& targets,
+                                                    int numThreads = 0);
+
+    // Menyimpan graf ke format biner CSR (lihat GraphFileHeader)
+    bool saveBinary(const std::string& path);
+
+    // Akses id vertex
+    int getVertexCount() const { return (int)vertexName.size(); }
+    int getVertexId(const std::string& name) const;
+    std::string getVertexName(int id) const { return vertexName[id]; }
+
     // Fungsi pembantu untuk menampilkan
     void printAdjMatrix();
     void printAdjList();
 };
+
+// Konstruktor untuk adjacency matrix berukuran V x V
+Graph::Graph(int V) : numVertices(V), adjMatrix(V, std::vector<int>(V, 0)), csrDirty(true), adjListStale(false) {}
+
+// Konstruktor untuk adjacency list
+Graph::Graph() : numVertices(0), csrDirty(true), adjListStale(false) {}
+
+// Mendaftarkan nama node dan mengembalikan id integernya
+int Graph::internVertex(const std::string& name) {
+    auto it = vertexId.find(name);
+    if (it != vertexId.end()) {
+        return it->second;
+    }
+    int id = (int)vertexName.size();
+    vertexId[name] = id;
+    vertexName.push_back(name);
+    adjList[name]; // Node tanpa edge keluar tetap tercatat
+    numVertices = (int)vertexName.size();
+    return id;
+}
+
+int Graph::getVertexId(const std::string& name) const {
+    auto it = vertexId.find(name);
+    return it == vertexId.end() ? -1 : it->second;
+}
+
+// Edge berarah src -> dest pada adjacency matrix
+void Graph::addEdgeMatrix(int src, int dest) {
+    if (src < 0 || dest < 0 || src >= (int)adjMatrix.size() || dest >= (int)adjMatrix.size()) {
+        return;
+    }
+    adjMatrix[src][dest] = 1;
+}
+
+// Edge berarah src -> dest pada adjacency list (bobot 1)
+void Graph::addEdgeList(std::string src, std::string dest) {
+    addEdgeList(src, dest, 1.0);
+}
+
+// Edge berarah berbobot src -> dest pada adjacency list
+void Graph::addEdgeList(std::string src, std::string dest, double weight) {
+    materializeAdjList();
+    internVertex(src);
+    internVertex(dest);
+    adjList[src].push_back(dest);
+    adjWeight[src].push_back(weight);
+    csrDirty = true;
+}
+
+// Menghapus edge src -> dest pertama; false jika edge tidak ada
+bool Graph::removeEdgeList(std::string src, std::string dest) {
+    materializeAdjList();
+    auto it = adjList.find(src);
+    if (it == adjList.end()) {
+        return false;
+    }
+    auto weight = adjWeight[src].begin();
+    for (auto v = it->second.begin(); v != it->second.end(); ++v, ++weight) {
+        if (*v == dest) {
+            it->second.erase(v);
+            adjWeight[src].erase(weight);
+            csrDirty = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Untuk graf besar (benchmark, data dari file) tanpa membuat jutaan string dan
+// node list. Adjacency list baru dibangun dari CSR saat pertama kali
+// dibutuhkan (addEdgeList, removeEdgeList, BFSList, printAdjList). Edge
+// dengan id di luar rentang diabaikan, seperti addEdgeMatrix.
+void Graph::loadEdges(int vertexCount, const std::vector<std::pair<int, int>>& edges,
+                      const std::vector<double>& weights) {
+    int n = std::max(0, vertexCount);
+    adjList.clear();
+    adjWeight.clear();
+    vertexName.resize(n);
+    std::vector<std::pair<std::string, int>> sortedNames(n);
+    for (int i = 0; i < n; i++) {
+        vertexName[i] = std::to_string(i);
+        sortedNames[i] = {vertexName[i], i};
+    }
+    // Map dari rentang terurut dibangun dalam waktu linear
+    std::sort(sortedNames.begin(), sortedNames.end());
+    vertexId = std::map<std::string, int>(sortedNames.begin(), sortedNames.end());
+    numVertices = n;
+
+    auto valid = [n](const std::pair<int, int>& e) {
+        return e.first >= 0 && e.second >= 0 && e.first < n && e.second < n;
+    };
+    csrOffset.assign(n + 1, 0);
+    csrInOffset.assign(n + 1, 0);
+    for (const auto& e : edges) {
+        if (valid(e)) {
+            csrOffset[e.first + 1]++;
+            csrInOffset[e.second + 1]++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        csrOffset[i + 1] += csrOffset[i];
+        csrInOffset[i + 1] += csrInOffset[i];
+    }
+    csrTarget.assign(csrOffset[n], 0);
+    csrWeight.assign(csrOffset[n], 0.0);
+    csrInSource.assign(csrInOffset[n], 0);
+    csrInWeight.assign(csrInOffset[n], 0.0);
+    std::vector<int> outPos(csrOffset.begin(), csrOffset.end() - 1);
+    std::vector<int> inPos(csrInOffset.begin(), csrInOffset.end() - 1);
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (!valid(edges[i])) {
+            continue;
+        }
+        int u = edges[i].first, v = edges[i].second;
+        double weight = i < weights.size() ? weights[i] : 1.0;
+        csrInWeight[inPos[v]] = weight;
+        csrInSource[inPos[v]++] = u;
+        csrWeight[outPos[u]] = weight;
+        csrTarget[outPos[u]++] = v;
+    }
+    csrDirty = false;
+    adjListStale = true;
+}
+
+// Membangun adjList/adjWeight dari CSR setelah loadEdges
+void Graph::materializeAdjList() {
+    if (!adjListStale) {
+        return;
+    }
+    adjListStale = false;
+    for (int u = 0; u < (int)vertexName.size(); u++) {
+        std::list<std::string>& out = adjList[vertexName[u]];
+        std::list<double>& weight = adjWeight[vertexName[u]];
+        for (int k = csrOffset[u]; k < csrOffset[u + 1]; k++) {
+            out.push_back(vertexName[csrTarget[k]]);
+            weight.push_back(csrWeight[k]);
+        }
+    }
+}
+
+// Membangun CSR edge keluar dan edge masuk dari adjList
+void Graph::buildCSR() {
+    if (!csrDirty) {
+        return;
+    }
+    int n = (int)vertexName.size();
+    csrOffset.assign(n + 1, 0);
+    csrInOffset.assign(n + 1, 0);
+
+    // Hitung derajat keluar dan masuk
+    for (const auto& entry : adjList) {
+        int u = vertexId[entry.first];
+        csrOffset[u + 1] += (int)entry.second.size();
+        for (const auto& dest : entry.second) {
+            csrInOffset[vertexId[dest] + 1]++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        csrOffset[i + 1] += csrOffset[i];
+        csrInOffset[i + 1] += csrInOffset[i];
+    }
+
+    // Isi daftar tetangga
+    csrTarget.assign(csrOffset[n], 0);
+    csrWeight.assign(csrOffset[n], 0.0);
+    csrInSource.assign(csrInOffset[n], 0);
+    csrInWeight.assign(csrInOffset[n], 0.0);
+    std::vector<int> outPos(csrOffset.begin(), csrOffset.end() - 1);
+    std::vector<int> inPos(csrInOffset.begin(), csrInOffset.end() - 1);
+    for (const auto& entry : adjList) {
+        int u = vertexId[entry.first];
+        auto weight = adjWeight[entry.first].begin();
+        for (const auto& dest : entry.second) {
+            int v = vertexId[dest];
+            csrInWeight[inPos[v]] = *weight;
+            csrWeight[outPos[u]] = *weight++;
+            csrTarget[outPos[u]++] = v;
+            csrInSource[inPos[v]++] = u;
+        }
+    }
+    csrDirty = false;
+}
+
+// BFS pada adjacency matrix, mengembalikan urutan kunjungan
+std::vector<int> Graph::BFSMatrix(int startVertex) {
+    std::vector<int> result;
+    int n = (int)adjMatrix.size();
+    if (startVertex < 0 || startVertex >= n) {
+        return result;
+    }
+
+    std::vector<bool> visited(n, false);
+    std::queue<int> q;
+    visited[startVertex] = true;
+    q.push(startVertex);
+
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        result.push_back(u);
+        for (int v = 0; v < n; v++) {
+            if (adjMatrix[u][v] && !visited[v]) {
+                visited[v] = true;
+                q.push(v);
+            }
+        }
+    }
+    return result;
+}
+
+// BFS pada adjacency list, mengembalikan urutan kunjungan
+std::vector<std::string> Graph::BFSList(std::string startVertex) {
+    materializeAdjList();
+    std::vector<std::string> result;
+    if (adjList.find(startVertex) == adjList.end()) {
+        return result;
+    }
+
+    std::map<std::string, bool> visited;
+    std::queue<std::string> q;
+    visited[startVertex] = true;
+    q.push(startVertex);
+
+    while (!q.empty()) {
+        std::string u = q.front();
+        q.pop();
+        result.push_back(u);
+        for (const auto& v : adjList[u]) {
+            if (!visited[v]) {
+                visited[v] = true;
+                q.push(v);
+            }
+        }
+    }
+    return result;
+}
+
+// Operasi bitset untuk penanda visited
+static inline bool testBit(const std::vector<uint64_t>& bits, int i) {
+    return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void setBit(std::vector<uint64_t>& bits, int i) {
+    bits[i >> 6] |= 1ULL << (i & 63);
+}
+
+// DFS iteratif dari satu vertex. Setiap frame stack menyimpan vertex dan
+// indeks edge berikutnya di CSR, sehingga urutan kunjungan sama dengan
+// versi rekursif tetapi kedalaman graf tidak dibatasi ukuran call stack.
+template <typename Visitor>
+void Graph::DFSFrom(int start, std::vector<uint64_t>& visited, Visitor& visitor) {
+    std::vector<std::pair<int, int>> stack;
+    setBit(visited, start);
+    visitor.preVisit(start);
+    stack.push_back({start, csrOffset[start]});
+
+    while (!stack.empty()) {
+        int u = stack.back().first;
+        int k = stack.back().second;
+        if (k < csrOffset[u + 1]) {
+            stack.back().second = k + 1;
+            int v = csrTarget[k];
+            if (!testBit(visited, v)) {
+                setBit(visited, v);
+                visitor.preVisit(v);
+                stack.push_back({v, csrOffset[v]});
+            }
+        } else {
+            visitor.postVisit(u);
+            stack.pop_back();
+        }
+    }
+}
+
+template <typename Visitor>
+void Graph::DFSVisit(std::string startVertex, Visitor& visitor) {
+    buildCSR();
+    int src = getVertexId(startVertex);
+    if (src < 0) {
+        return;
+    }
+    std::vector<uint64_t> visited((vertexName.size() + 63) / 64, 0);
+    DFSFrom(src, visited, visitor);
+}
+
+// Visitor yang mengumpulkan nama vertex dalam urutan preorder
+struct CollectNamesVisitor {
+    const Graph& graph;
+    std::vector<std::string>& result;
+    void preVisit(int id) { result.push_back(graph.getVertexName(id)); }
+    void postVisit(int) {}
+};
+
+// DFS pada adjacency list, mengembalikan urutan kunjungan
+std::vector<std::string> Graph::DFSList(std::string startVertex) {
+    std::vector<std::string> result;
+    CollectNamesVisitor visitor{*this, result};
+    DFSVisit(startVertex, visitor);
+    return result;
+}
+
+// Visitor untuk topological sort: urutan postorder + deteksi back edge
+struct TopoVisitor {
+    const std::vector<int>& offset;
+    const std::vector<int>& target;
+    std::vector<uint64_t> onStack;
+    std::vector<int> postorder;
+    bool hasCycle = false;
+
+    void preVisit(int id) {
+        setBit(onStack, id);
+        // Edge ke vertex yang masih di stack DFS adalah back edge (siklus)
+        for (int k = offset[id]; k < offset[id + 1] && !hasCycle; k++) {
+            hasCycle = testBit(onStack, target[k]);
+        }
+    }
+    void postVisit(int id) {
+        onStack[id >> 6] &= ~(1ULL << (id & 63));
+        postorder.push_back(id);
+    }
+};
+
+bool Graph::topologicalSort(std::vector<std::string>& order) {
+    buildCSR();
+    int n = (int)vertexName.size();
+    std::vector<uint64_t> visited((n + 63) / 64, 0);
+    TopoVisitor visitor{csrOffset, csrTarget, std::vector<uint64_t>((n + 63) / 64, 0), {}};
+    visitor.postorder.reserve(n);
+
+    for (int v = 0; v < n && !visitor.hasCycle; v++) {
+        if (!testBit(visited, v)) {
+            DFSFrom(v, visited, visitor);
+        }
+    }
+    order.clear();
+    if (visitor.hasCycle) {
+        return false;
+    }
+    for (auto it = visitor.postorder.rbegin(); it != visitor.postorder.rend(); ++it) {
+        order.push_back(vertexName[*it]);
+    }
+    return true;
+}
+
+// Tarjan iteratif: index/lowlink disimpan di array, call stack eksplisit
+int Graph::stronglyConnectedComponents(std::vector<int>& componentOf) {
+    buildCSR();
+    int n = (int)vertexName.size();
+    std::vector<int> index(n, -1), low(n, 0);
+    std::vector<uint64_t> onStack((n + 63) / 64, 0);
+    std::vector<int> sccStack;
+    std::vector<std::pair<int, int>> callStack;
+    componentOf.assign(n, -1);
+    int counter = 0, components = 0;
+
+    for (int root = 0; root < n; root++) {
+        if (index[root] != -1) {
+            continue;
+        }
+        index[root] = low[root] = counter++;
+        sccStack.push_back(root);
+        setBit(onStack, root);
+        callStack.push_back({root, csrOffset[root]});
+
+        while (!callStack.empty()) {
+            int v = callStack.back().first;
+            int k = callStack.back().second;
+            if (k < csrOffset[v + 1]) {
+                callStack.back().second = k + 1;
+                int w = csrTarget[k];
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    sccStack.push_back(w);
+                    setBit(onStack, w);
+                    callStack.push_back({w, csrOffset[w]});
+                } else if (testBit(onStack, w)) {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            // Semua tetangga v selesai diproses
+            callStack.pop_back();
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[w >> 6] &= ~(1ULL << (w & 63));
+                    componentOf[w] = components;
+                } while (w != v);
+                components++;
+            }
+            if (!callStack.empty()) {
+                int parent = callStack.back().first;
+                low[parent] = std::min(low[parent], low[v]);
+            }
+        }
+    }
+    return components;
+}
+
+// BFS serial berbasis queue di atas CSR, mengembalikan level per id vertex
+std::vector<int> Graph::BFSLevels(std::string startVertex) {
+    buildCSR();
+    std::vector<int> level(vertexName.size(), -1);
+    int src = getVertexId(startVertex);
+    if (src < 0) {
+        return level;
+    }
+
+    std::queue<int> q;
+    level[src] = 0;
+    q.push(src);
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        for (int k = csrOffset[u]; k < csrOffset[u + 1]; k++) {
+            int v = csrTarget[k];
+            if (level[v] == -1) {
+                level[v] = level[u] + 1;
+                q.push(v);
+            }
+        }
+    }
+    return level;
+}
+
+// Pool thread tetap untuk pekerjaan yang dibagi per fase (misalnya satu level BFS).
+// Thread dibuat sekali di konstruktor; run() hanya membangunkan worker, membagi
+// [0, count) menjadi blok berurutan (thread pemanggil mengerjakan blok 0) dan
+// menunggu semua blok selesai. Biaya per fase beberapa mikrodetik, bukan
+// spawn + join thread baru di setiap level.
+class WorkerPool {
+private:
+    using Task = std::function<void(int, size_t, size_t)>;
+
+    int numThreads;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    const Task* task = nullptr;
+    size_t count = 0;
+    uint64_t generation = 0; // bertambah setiap run(), tanda ada pekerjaan baru
+    int pending = 0;         // worker yang belum selesai untuk generation ini
+    bool stopping = false;
+
+    void runBlock(const Task& job, int t, size_t n) const {
+        size_t chunk = (n + numThreads - 1) / numThreads;
+        size_t begin = std::min(n, t * chunk);
+        job(t, begin, std::min(n, begin + chunk));
+    }
+
+    void workerLoop(int t) {
+        uint64_t seen = 0;
+        for (;;) {
+            const Task* job;
+            size_t n;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                job = task;
+                n = count;
+            }
+            runBlock(*job, t, n);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+public:
+    // numThreads <= 0 berarti semua core
+    explicit WorkerPool(int threads) {
+        numThreads = threads > 0 ? threads : (int)std::max(1u, std::thread::hardware_concurrency());
+        for (int t = 1; t < numThreads; t++) {
+            workers.emplace_back(&WorkerPool::workerLoop, this, t);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return numThreads; }
+
+    // task(t, begin, end) dipanggil sekali untuk setiap thread t (rentang boleh kosong)
+    void run(size_t n, const Task& job) {
+        if (numThreads <= 1 || n < 2) {
+            job(0, 0, n);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &job;
+            count = n;
+            pending = numThreads - 1;
+            generation++;
+        }
+        wake.notify_all();
+        runBlock(job, 0, n);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pending == 0; });
+    }
+};
+
+/**
+ * BFS paralel direction-optimizing (Beamer dkk.).
+ *
+ * - Top-down: setiap thread mengembangkan sebagian frontier (queue sparse),
+ *   vertex baru diklaim dengan fetch_or atomik pada bitmap visited.
+ * - Bottom-up: setiap thread memeriksa sekelompok word bitmap vertex yang
+ *   belum dikunjungi dan mencari parent lewat edge masuk di bitmap frontier.
+ *
+ * Pindah ke bottom-up jika edge frontier > edge belum dijelajahi / ALPHA,
+ * kembali ke top-down jika frontier mengecil di bawah n / BETA.
+ */
+std::vector<int> Graph::parallelBFSLevels(std::string startVertex, int numThreads) {
+    const long long ALPHA = 14;
+    const long long BETA = 24;
+
+    buildCSR();
+    int n = (int)vertexName.size();
+    std::vector<int> level(n, -1);
+    int src = getVertexId(startVertex);
+    if (src < 0) {
+        return level;
+    }
+    // Thread dibuat sekali untuk seluruh traversal, bukan per level
+    WorkerPool pool(numThreads);
+    numThreads = pool.size();
+
+    size_t words = ((size_t)n + 63) / 64;
+    std::vector<std::atomic<uint64_t>> visited(words);
+    for (auto& w : visited) {
+        w.store(0, std::memory_order_relaxed);
+    }
+    std::vector<uint64_t> frontierBits(words, 0), nextBits(words, 0);
+    std::vector<int> frontier;
+    std::vector<std::vector<int>> localNext(numThreads);
+    std::vector<long long> localEdges(numThreads), localCount(numThreads);
+
+    level[src] = 0;
+    visited[src >> 6].fetch_or(1ULL << (src & 63));
+    frontier.push_back(src);
+
+    long long edgesToCheck = csrOffset[n];
+    long long frontierEdges = csrOffset[src + 1] - csrOffset[src];
+    long long frontierSize = 1;
+    long long prevSize = 0;
+    bool bottomUp = false;
+    int depth = 0;
+
+    while (frontierSize > 0) {
+        // Pilih arah ekspansi untuk level ini
+        if (!bottomUp && frontierEdges > edgesToCheck / ALPHA) {
+            std::fill(frontierBits.begin(), frontierBits.end(), 0);
+            for (int u : frontier) {
+                frontierBits[u >> 6] |= 1ULL << (u & 63);
+            }
+            bottomUp = true;
+        } else if (bottomUp && frontierSize < n / BETA && frontierSize < prevSize) {
+            frontier.clear();
+            for (size_t w = 0; w < words; w++) {
+                for (uint64_t bits = frontierBits[w]; bits; bits &= bits - 1) {
+                    frontier.push_back((int)(w * 64 + __builtin_ctzll(bits)));
+                }
+            }
+            bottomUp = false;
+        }
+        edgesToCheck -= frontierEdges;
+        prevSize = frontierSize;
+        int nextLevel = depth + 1;
+
+        if (!bottomUp) {
+            pool.run(frontier.size(), [&](int t, size_t begin, size_t end) {
+                std::vector<int>& out = localNext[t];
+                long long edges = 0;
+                out.clear();
+                for (size_t i = begin; i < end; i++) {
+                    int u = frontier[i];
+                    for (int k = csrOffset[u]; k < csrOffset[u + 1]; k++) {
+                        int v = csrTarget[k];
+                        uint64_t mask = 1ULL << (v & 63);
+                        if (visited[v >> 6].load(std::memory_order_relaxed) & mask) {
+                            continue;
+                        }
+                        if (!(visited[v >> 6].fetch_or(mask, std::memory_order_relaxed) & mask)) {
+                            level[v] = nextLevel;
+                            out.push_back(v);
+                            edges += csrOffset[v + 1] - csrOffset[v];
+                        }
+                    }
+                }
+                localEdges[t] = edges;
+            });
+            frontier.clear();
+            frontierEdges = 0;
+            for (int t = 0; t < numThreads; t++) {
+                frontier.insert(frontier.end(), localNext[t].begin(), localNext[t].end());
+                frontierEdges += localEdges[t];
+                localNext[t].clear();
+                localEdges[t] = 0;
+            }
+            frontierSize = (long long)frontier.size();
+        } else {
+            // Setiap thread memiliki word bitmap sendiri, jadi nextBits bebas race
+            pool.run(words, [&](int t, size_t begin, size_t end) {
+                long long edges = 0, count = 0;
+                for (size_t w = begin; w < end; w++) {
+                    uint64_t seen = visited[w].load(std::memory_order_relaxed);
+                    uint64_t found = 0;
+                    for (int bit = 0; bit < 64; bit++) {
+                        int v = (int)(w * 64 + bit);
+                        if (v >= n) {
+                            break;
+                        }
+                        if (seen & (1ULL << bit)) {
+                            continue;
+                        }
+                        for (int k = csrInOffset[v]; k < csrInOffset[v + 1]; k++) {
+                            int u = csrInSource[k];
+                            if (frontierBits[u >> 6] & (1ULL << (u & 63))) {
+                                level[v] = nextLevel;
+                                found |= 1ULL << bit;
+                                edges += csrOffset[v + 1] - csrOffset[v];
+                                count++;
+                                break;
+                            }
+                        }
+                    }
+                    nextBits[w] = found;
+                    if (found) {
+                        visited[w].fetch_or(found, std::memory_order_relaxed);
+                    }
+                }
+                localEdges[t] = edges;
+                localCount[t] = count;
+            });
+            frontierBits.swap(nextBits);
+            frontierEdges = 0;
+            frontierSize = 0;
+            for (int t = 0; t < numThreads; t++) {
+                frontierEdges += localEdges[t];
+                frontierSize += localCount[t];
+                localEdges[t] = 0;
+                localCount[t] = 0;
+            }
+        }
+        depth = nextLevel;
+    }
+    return level;
+}
+
+template <typename Heuristic, typename StopCondition>
+void Graph::searchShortestPath(int src, Heuristic h, StopCondition stop, ShortestPathWorkspace& ws,
+                               bool backward) {
+    const int* offset = backward ? csrInOffset.data() : csrOffset.data();
+    const int* neighbor = backward ? csrInSource.data() : csrTarget.data();
+    const double* weight = backward ? csrInWeight.data() : csrWeight.data();
+    ws.dist[src] = 0.0;
+    ws.touched.push_back(src);
+    ws.heap.pushOrDecrease(src, h(src));
+
+    while (!ws.heap.empty()) {
+        int u = ws.heap.popMin();
+        if (stop(u)) {
+            return;
+        }
+        double du = ws.dist[u];
+        for (int k = offset[u]; k < offset[u + 1]; k++) {
+            int v = neighbor[k];
+            double candidate = du + weight[k];
+            if (candidate < ws.dist[v]) {
+                if (ws.dist[v] == std::numeric_limits<double>::infinity()) {
+                    ws.touched.push_back(v);
+                }
+                ws.dist[v] = candidate;
+                ws.parent[v] = u;
+                ws.heap.pushOrDecrease(v, candidate + h(v));
+            }
+        }
+    }
+}
+
+std::vector<double> Graph::dijkstra(std::string source) {
+    buildCSR();
+    ShortestPathWorkspace ws((int)vertexName.size());
+    int src = getVertexId(source);
+    if (src >= 0) {
+        searchShortestPath(src, [](int) { return 0.0; }, [](int) { return false; }, ws);
+    }
+    return ws.dist;
+}
+
+template <typename Heuristic>
+double Graph::aStar(std::string source, std::string target, Heuristic h, std::vector<std::string>* path) {
+    buildCSR();
+    int src = getVertexId(source);
+    int dst = getVertexId(target);
+    if (path) {
+        path->clear();
+    }
+    if (src < 0 || dst < 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    ShortestPathWorkspace ws((int)vertexName.size());
+    searchShortestPath(src, h, [dst](int u) { return u == dst; }, ws);
+
+    if (path && ws.dist[dst] < std::numeric_limits<double>::infinity()) {
+        for (int v = dst; v != -1; v = ws.parent[v]) {
+            path->push_back(vertexName[v]);
+        }
+        std::reverse(path->begin(), path->end());
+    }
+    return ws.dist[dst];
+}
+
+/**
+ * Many-to-many berbasis bucket (Knopp dkk.), tanpa contraction hierarchy.
+ *
+ * 1. Pencarian mundur dari setiap target t menetapkan semua vertex dengan
+ *    jarak ke t <= radius (atau berhenti lebih awal jika semua source sudah
+ *    ditetapkan); setiap vertex v yang ditetapkan mendapat entri
+ *    (t, jarak v -> t) di bucket-nya. reach[t] = kunci saat pencarian
+ *    berhenti (tak hingga jika pencarian habis), jadi setiap vertex di luar
+ *    bola berjarak >= reach[t] ke t.
+ * 2. Pencarian maju dari setiap source s memindai bucket setiap vertex yang
+ *    ditetapkan dan memperbarui D[s][t]. Jika jalur terpendek s -> t belum
+ *    terlihat, vertex pertamanya di bola t belum ditetapkan, sehingga
+ *    panjangnya >= kunci + reach[t] - bobot edge terbesar. Pencarian berhenti
+ *    saat batas itu >= D[s][t] untuk semua t.
+ *
+ * Kerja dibagi antar pencarian: bola mundur selebar radius dipakai oleh
+ * semua source, dan setiap pencarian maju cukup menempuh sisa jaraknya.
+ * Jika titik-titiknya berdekatan dibanding ukuran graf (misalnya pengiriman
+ * dalam satu kota pada jaringan jalan satu negara), radius setengah jarak
+ * membuat kerjanya kira-kira 1 + |S||T| / (|S| + |T|) pencarian penuh,
+ * bukan min(|S|, |T|).
+ *
+ * Radius dipilih dari pencarian source pertama (barisnya langsung menjadi
+ * hasil): jumlah vertex yang ditetapkan sampai jarak r dipakai sebagai
+ * perkiraan biaya bola berjari-jari r, lalu dipilih r yang meminimalkan
+ * |T| * N(r) + (|S| - 1) * N(jarak terjauh - r). Jika titik-titiknya
+ * tersebar di seluruh graf, bola besar saling tumpang tindih dan hasilnya
+ * radius 0 (hanya pencarian maju) atau tak hingga (bola mundur yang berhenti
+ * setelah semua source ditetapkan, pencarian maju berhenti di source), yaitu
+ * pencarian per vertex di sisi yang lebih kecil. Jika salah satu sisi jauh
+ * lebih kecil, pilihan itu diambil tanpa pencarian percobaan.
+ */
+std::vector<std::vector<double>> Graph::distanceMatrix(const std::vector<std::string>& sources,
+                                                       const std::vector<std::string>& targets,
+                                                       int numThreads) {
+    buildCSR();
+    int n = (int)vertexName.size();
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<std::vector<double>> result(sources.size(), std::vector<double>(targets.size(), INF));
+
+    // ids[i] = id nama ke-i (-1 jika tidak ada), distinct = id unik, column[id] = indeks di distinct
+    auto collect = [&](const std::vector<std::string>& names, std::vector<int>& ids, std::vector<int>& distinct,
+                       std::vector<int>& column) {
+        column.assign(n, -1);
+        for (const auto& name : names) {
+            int id = getVertexId(name);
+            ids.push_back(id);
+            if (id >= 0 && column[id] < 0) {
+                column[id] = (int)distinct.size();
+                distinct.push_back(id);
+            }
+        }
+    };
+    std::vector<int> sourceIds, targetIds, distinctSources, distinctTargets, sourceColumn, targetColumn;
+    collect(sources, sourceIds, distinctSources, sourceColumn);
+    collect(targets, targetIds, distinctTargets, targetColumn);
+    size_t S = distinctSources.size(), T = distinctTargets.size();
+    if (S == 0 || T == 0) {
+        return result;
+    }
+
+    auto noHeuristic = [](int) { return 0.0; };
+    WorkerPool pool(numThreads);
+    std::vector<std::unique_ptr<ShortestPathWorkspace>> workspaces(pool.size());
+    auto workspace = [&](int thread) -> ShortestPathWorkspace& {
+        if (!workspaces[thread]) {
+            workspaces[thread].reset(new ShortestPathWorkspace(n));
+        }
+        return *workspaces[thread];
+    };
+
+    double maxWeight = 0.0;
+    for (double w : csrWeight) {
+        maxWeight = std::max(maxWeight, w);
+    }
+
+    // table[s * T + t] = jarak distinctSources[s] -> distinctTargets[t]
+    std::vector<double> table(S * T, INF);
+    double balancedWork = 1.0 + (double)S * T / (double)(S + T);
+    bool balanced = balancedWork < (double)std::min(S, T);
+    double radius = T < S ? INF : 0.0;
+    size_t firstForward = 0;
+    if (balanced) {
+        ShortestPathWorkspace& ws = workspace(0);
+        size_t remaining = T;
+        std::vector<double> settled; // jarak vertex yang ditetapkan, naik
+        searchShortestPath(distinctSources[0], noHeuristic, [&](int u) {
+            settled.push_back(ws.dist[u]);
+            return targetColumn[u] >= 0 && --remaining == 0;
+        }, ws);
+        double farthest = 0.0;
+        for (size_t t = 0; t < T; t++) {
+            table[t] = ws.dist[distinctTargets[t]];
+            if (table[t] < INF) {
+                farthest = std::max(farthest, table[t]);
+            }
+        }
+        ws.reset();
+        firstForward = 1;
+
+        auto within = [&](double r) {
+            return (double)(std::upper_bound(settled.begin(), settled.end(), r) - settled.begin());
+        };
+        // Radius di antara hanya dipakai jika perkiraannya jauh lebih murah
+        // daripada pencarian per vertex: biaya bucket dan pencarian maju yang
+        // ditentukan target terjauhnya tidak ikut diperkirakan
+        radius = T < S - 1 ? INF : 0.0;
+        double bestCost = 0.6 * (double)std::min(S - 1, T) * within(farthest);
+        for (int step = 1; step < 64; step++) {
+            double r = farthest * step / 64;
+            double cost = (double)T * within(r) + (double)(S - 1) * within(farthest - r + maxWeight);
+            if (cost < bestCost) {
+                bestCost = cost;
+                radius = r;
+            }
+        }
+    }
+
+    // Bola mundur setiap target
+    std::vector<std::vector<std::pair<int, double>>> balls(T);
+    std::vector<double> reach(T, INF);
+    pool.run(T, [&](int thread, size_t begin, size_t end) {
+        ShortestPathWorkspace& ws = workspace(thread);
+        for (size_t t = begin; t < end; t++) {
+            size_t sourcesLeft = S;
+            searchShortestPath(distinctTargets[t], noHeuristic, [&](int u) {
+                if (ws.dist[u] > radius || sourcesLeft == 0) {
+                    reach[t] = ws.dist[u];
+                    return true;
+                }
+                balls[t].push_back({u, ws.dist[u]});
+                sourcesLeft -= sourceColumn[u] >= 0;
+                return false;
+            }, ws, true);
+            ws.reset();
+        }
+    });
+
+    // Bucket per vertex disusun seperti CSR: entri v ada di [bucketOffset[v], bucketOffset[v+1])
+    std::vector<size_t> bucketOffset(n + 1, 0);
+    for (const auto& ball : balls) {
+        for (const auto& entry : ball) {
+            bucketOffset[entry.first + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        bucketOffset[v + 1] += bucketOffset[v];
+    }
+    std::vector<int> bucketTarget(bucketOffset[n]);
+    std::vector<double> bucketDist(bucketOffset[n]);
+    {
+        std::vector<size_t> position(bucketOffset.begin(), bucketOffset.end() - 1);
+        for (size_t t = 0; t < T; t++) {
+            for (const auto& entry : balls[t]) {
+                size_t k = position[entry.first]++;
+                bucketTarget[k] = (int)t;
+                bucketDist[k] = entry.second;
+            }
+        }
+        std::vector<std::vector<std::pair<int, double>>>().swap(balls);
+    }
+
+    // Pencarian maju dari source lain
+    pool.run(S - firstForward, [&](int thread, size_t begin, size_t end) {
+        ShortestPathWorkspace& ws = workspace(thread);
+        for (size_t i = begin; i < end; i++) {
+            double* row = &table[(i + firstForward) * T];
+            // Kunci minimum agar semua D[s][t] pasti final
+            auto finalKey = [&]() {
+                double key = -INF;
+                for (size_t t = 0; t < T; t++) {
+                    if (reach[t] < INF) {
+                        key = std::max(key, row[t] - reach[t] + maxWeight);
+                    }
+                }
+                return key;
+            };
+            double threshold = finalKey();
+            searchShortestPath(distinctSources[i + firstForward], noHeuristic, [&](int u) {
+                double du = ws.dist[u];
+                bool improved = false;
+                for (size_t k = bucketOffset[u]; k < bucketOffset[u + 1]; k++) {
+                    double candidate = du + bucketDist[k];
+                    if (candidate < row[bucketTarget[k]]) {
+                        row[bucketTarget[k]] = candidate;
+                        improved = true;
+                    }
+                }
+                if (improved) {
+                    threshold = finalKey();
+                }
+                return du >= threshold;
+            }, ws);
+            ws.reset();
+        }
+    });
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        for (size_t j = 0; j < targets.size(); j++) {
+            if (sourceIds[i] >= 0 && targetIds[j] >= 0) {
+                result[i][j] = table[sourceColumn[sourceIds[i]] * T + targetColumn[targetIds[j]]];
+            }
+        }
+    }
+    return result;
+}
+
+// Menampilkan adjacency matrix
+void Graph::printAdjMatrix() {
+    for (const auto& row : adjMatrix) {
+        for (int cell : row) {
+            std::cout << cell << " ";
+        }
+        std::cout << "\n";
+    }
+}
+
+// Menampilkan adjacency list
+void Graph::printAdjList() {
+    materializeAdjList();
+    for (const auto& entry : adjList) {
+        std::cout << entry.first << " ->";
+        for (const auto& v : entry.second) {
+            std::cout << " " << v;
+        }
+        std::cout << "\n";
+    }
+}
+
+// ===================== Format biner graf =====================
+//
+// File berisi header diikuti section yang masing-masing rata 8 byte:
+//   offsets     : uint64 x (V + 1)  -> CSR, edge u ada di [offsets[u], offsets[u+1])
+//   targets     : uint32 x E
+//   weights     : double x E        -> hanya jika flags & GRAPH_FILE_WEIGHTED
+//   nameOffsets : uint64 x (V + 1)  -> nama u ada di nameData[nameOffsets[u] ..)
+//   sortedNames : uint32 x V        -> id vertex terurut menurut nama (binary search)
+//   nameData    : char x nameBytes
+// Angka disimpan dalam byte order host (little-endian di x86/ARM), sehingga file
+// bisa langsung di-mmap tanpa parsing. File dari host dengan byte order lain
+// ditolak saat dibuka karena field version terbaca sebagai angka lain.
+
+const char GRAPH_FILE_MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_FILE_WEIGHTED = 1;
+
+struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t numVertices;
+    uint64_t numEdges;
+    uint64_t nameBytes;
+    uint64_t offsetsPos;
+    uint64_t targetsPos;
+    uint64_t weightsPos;
+    uint64_t nameOffsetsPos;
+    uint64_t sortedNamesPos;
+    uint64_t nameDataPos;
+    uint64_t fileSize;
+};
+
+// fseek 64-bit agar file lebih dari 2 GB tetap bisa ditulis
+static bool seekTo(std::FILE* file, uint64_t pos) {
+#ifdef _WIN32
+    return _fseeki64(file, (long long)pos, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)pos, SEEK_SET) == 0;
+#endif
+}
+
+static uint64_t alignTo8(uint64_t pos) {
+    return (pos + 7) & ~(uint64_t)7;
+}
+
+// Mengisi header dan menghitung posisi setiap section
+static GraphFileHeader makeGraphFileHeader(uint64_t numVertices, uint64_t numEdges,
+                                           uint64_t nameBytes, bool weighted) {
+    GraphFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, GRAPH_FILE_MAGIC, sizeof(h.magic));
+    h.version = GRAPH_FILE_VERSION;
+    h.flags = weighted ? GRAPH_FILE_WEIGHTED : 0;
+    h.numVertices = numVertices;
+    h.numEdges = numEdges;
+    h.nameBytes = nameBytes;
+    h.offsetsPos = alignTo8(sizeof(GraphFileHeader));
+    h.targetsPos = alignTo8(h.offsetsPos + (numVertices + 1) * sizeof(uint64_t));
+    h.weightsPos = alignTo8(h.targetsPos + numEdges * sizeof(uint32_t));
+    h.nameOffsetsPos = alignTo8(h.weightsPos + (weighted ? numEdges * sizeof(double) : 0));
+    h.sortedNamesPos = alignTo8(h.nameOffsetsPos + (numVertices + 1) * sizeof(uint64_t));
+    h.nameDataPos = alignTo8(h.sortedNamesPos + numVertices * sizeof(uint32_t));
+    h.fileSize = h.nameDataPos + nameBytes;
+    return h;
+}
+
+// Menulis section nama (nameOffsets, sortedNames, nameData) ke posisi header
+static bool writeGraphFileNames(std::FILE* file, const GraphFileHeader& h,
+                                const std::vector<std::string>& names) {
+    std::vector<uint64_t> nameOffsets(names.size() + 1, 0);
+    for (size_t i = 0; i < names.size(); i++) {
+        nameOffsets[i + 1] = nameOffsets[i] + names[i].size();
+    }
+    std::vector<uint32_t> sortedNames(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        sortedNames[i] = (uint32_t)i;
+    }
+    std::sort(sortedNames.begin(), sortedNames.end(),
+              [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+
+    bool ok = seekTo(file, h.nameOffsetsPos) &&
+              std::fwrite(nameOffsets.data(), sizeof(uint64_t), nameOffsets.size(), file) == nameOffsets.size() &&
+              seekTo(file, h.sortedNamesPos) &&
+              std::fwrite(sortedNames.data(), sizeof(uint32_t), sortedNames.size(), file) == sortedNames.size() &&
+              seekTo(file, h.nameDataPos);
+    for (size_t i = 0; ok && i < names.size(); i++) {
+        ok = std::fwrite(names[i].data(), 1, names[i].size(), file) == names[i].size();
+    }
+    return ok;
+}
+
+bool Graph::saveBinary(const std::string& path) {
+    buildCSR();
+    uint64_t n = vertexName.size();
+    uint64_t m = csrTarget.size();
+    uint64_t nameBytes = 0;
+    bool weighted = false;
+    for (const auto& name : vertexName) {
+        nameBytes += name.size();
+    }
+    for (double w : csrWeight) {
+        weighted = weighted || w != 1.0;
+    }
+    GraphFileHeader h = makeGraphFileHeader(n, m, nameBytes, weighted);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::vector<uint64_t> offsets(csrOffset.begin(), csrOffset.end());
+    std::vector<uint32_t> targets(csrTarget.begin(), csrTarget.end());
+    bool ok = std::fwrite(&h, sizeof(h), 1, file) == 1 &&
+              seekTo(file, h.offsetsPos) &&
+              std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size() &&
+              seekTo(file, h.targetsPos) &&
+              std::fwrite(targets.data(), sizeof(uint32_t), targets.size(), file) == targets.size();
+    if (ok && weighted) {
+        ok = seekTo(file, h.weightsPos) &&
+             std::fwrite(csrWeight.data(), sizeof(double), m, file) == m;
+    }
+    ok = ok && writeGraphFileNames(file, h, vertexName);
+    return std::fclose(file) == 0 && ok;
+}
+
+// Graf read-only yang dibaca langsung dari file biner lewat mmap.
+// Pointer section menunjuk ke halaman file yang dipetakan, tanpa parsing/copy.
+class MappedGraph {
+private:
+    const char* data;
+    uint64_t size;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#else
+    int fd;
+#endif
+    const GraphFileHeader* header;
+    const uint64_t* offsets;
+    const uint32_t* targets;
+    const double* weights;
+    const uint64_t* nameOffsets;
+    const uint32_t* sortedNames;
+    const char* nameData;
+
+    bool sectionFits(uint64_t pos, uint64_t count, uint64_t elementSize) const;
+    bool validateSections() const;
+    bool validateContents() const;
+
+public:
+    MappedGraph();
+    ~MappedGraph() { close(); }
+    MappedGraph(const MappedGraph&) = delete;
+    MappedGraph& operator=(const MappedGraph&) = delete;
+
+    // Memetakan file; false jika file tidak ada, rusak, atau versinya berbeda.
+    // Posisi section diperiksa terhadap ukuran file, lalu isi CSR dan tabel
+    // nama diperiksa sekali secara berurutan (O(V + E)) agar query tidak
+    // pernah membaca di luar mapping.
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t getVertexCount() const { return header->numVertices; }
+    uint64_t getEdgeCount() const { return header->numEdges; }
+    bool isWeighted() const { return weights != nullptr; }
+
+    // Tetangga u ada di [neighborsBegin(u), neighborsEnd(u))
+    const uint32_t* neighborsBegin(uint32_t u) const { return targets + offsets[u]; }
+    const uint32_t* neighborsEnd(uint32_t u) const { return targets + offsets[u + 1]; }
+    // Bobot edge ke-k (indeks CSR), 1 jika graf tidak berbobot
+    double getWeight(uint64_t k) const { return weights ? weights[k] : 1.0; }
+
+    std::string getVertexName(uint32_t id) const;
+    // Binary search nama pada section sortedNames, -1 jika tidak ada
+    int64_t getVertexId(const std::string& name) const;
+
+    std::vector<int> BFSLevels(const std::string& startVertex) const;
+};
+
+MappedGraph::MappedGraph()
+    : data(nullptr), size(0),
+#ifdef _WIN32
+      fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr),
+#else
+      fd(-1),
+#endif
+      header(nullptr), offsets(nullptr), targets(nullptr), weights(nullptr),
+      nameOffsets(nullptr), sortedNames(nullptr), nameData(nullptr) {}
+
+bool MappedGraph::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileHandle, &fileSize);
+    size = (uint64_t)fileSize.QuadPart;
+    mappingHandle = size ? CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    data = mappingHandle ? (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close();
+        return false;
+    }
+    size = (uint64_t)st.st_size;
+    void* mapped = size ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    data = mapped == MAP_FAILED ? nullptr : (const char*)mapped;
+#endif
+    if (!data || size < sizeof(GraphFileHeader)) {
+        close();
+        return false;
+    }
+
+    header = (const GraphFileHeader*)data;
+    if (std::memcmp(header->magic, GRAPH_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != GRAPH_FILE_VERSION || header->fileSize != size) {
+        close();
+        return false;
+    }
+    if (!validateSections()) {
+        close();
+        return false;
+    }
+    offsets = (const uint64_t*)(data + header->offsetsPos);
+    targets = (const uint32_t*)(data + header->targetsPos);
+    weights = (header->flags & GRAPH_FILE_WEIGHTED) ? (const double*)(data + header->weightsPos) : nullptr;
+    nameOffsets = (const uint64_t*)(data + header->nameOffsetsPos);
+    sortedNames = (const uint32_t*)(data + header->sortedNamesPos);
+    nameData = data + header->nameDataPos;
+    if (!validateContents()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Section [pos, pos + count * elementSize) rata 8 byte dan berada di dalam file
+bool MappedGraph::sectionFits(uint64_t pos, uint64_t count, uint64_t elementSize) const {
+    return pos % 8 == 0 && pos >= sizeof(GraphFileHeader) && pos <= size &&
+           count <= (size - pos) / elementSize;
+}
+
+bool MappedGraph::validateSections() const {
+    const GraphFileHeader& h = *header;
+    // Id vertex disimpan sebagai uint32 dan level BFS sebagai int
+    if (h.numVertices >= (uint64_t)std::numeric_limits<int>::max() || (h.flags & ~GRAPH_FILE_WEIGHTED) != 0) {
+        return false;
+    }
+    bool weighted = (h.flags & GRAPH_FILE_WEIGHTED) != 0;
+    return sectionFits(h.offsetsPos, h.numVertices + 1, sizeof(uint64_t)) &&
+           sectionFits(h.targetsPos, h.numEdges, sizeof(uint32_t)) &&
+           (!weighted || sectionFits(h.weightsPos, h.numEdges, sizeof(double))) &&
+           sectionFits(h.nameOffsetsPos, h.numVertices + 1, sizeof(uint64_t)) &&
+           sectionFits(h.sortedNamesPos, h.numVertices, sizeof(uint32_t)) &&
+           h.nameDataPos <= size && h.nameBytes <= size - h.nameDataPos;
+}
+
+bool MappedGraph::validateContents() const {
+    uint64_t n = header->numVertices;
+    if (offsets[0] != 0 || offsets[n] != header->numEdges || nameOffsets[0] != 0 ||
+        nameOffsets[n] != header->nameBytes) {
+        return false;
+    }
+    for (uint64_t u = 0; u < n; u++) {
+        if (offsets[u] > offsets[u + 1] || nameOffsets[u] > nameOffsets[u + 1]) {
+            return false;
+        }
+        if (sortedNames[u] >= n) {
+            return false;
+        }
+    }
+    for (uint64_t k = 0; k < header->numEdges; k++) {
+        if (targets[k] >= n) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MappedGraph::close() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data) {
+        munmap((void*)data, size);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    fd = -1;
+#endif
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    offsets = nameOffsets = nullptr;
+    targets = sortedNames = nullptr;
+    weights = nullptr;
+    nameData = nullptr;
+}
+
+std::string MappedGraph::getVertexName(uint32_t id) const {
+    return std::string(nameData + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+}
+
+int64_t MappedGraph::getVertexId(const std::string& name) const {
+    uint64_t lo = 0, hi = header->numVertices;
+    while (lo < hi) {
+        uint64_t mid = (lo + hi) / 2;
+        uint32_t id = sortedNames[mid];
+        int cmp = name.compare(0, std::string::npos, nameData + nameOffsets[id],
+                               nameOffsets[id + 1] - nameOffsets[id]);
+        if (cmp == 0) {
+            return id;
+        }
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return -1;
+}
+
+std::vector<int> MappedGraph::BFSLevels(const std::string& startVertex) const {
+    std::vector<int> level(header->numVertices, -1);
+    int64_t src = getVertexId(startVertex);
+    if (src < 0) {
+        return level;
+    }
+    std::queue<uint32_t> q;
+    level[src] = 0;
+    q.push((uint32_t)src);
+    while (!q.empty()) {
+        uint32_t u = q.front();
+        q.pop();
+        for (const uint32_t* v = neighborsBegin(u); v != neighborsEnd(u); ++v) {
+            if (level[*v] == -1) {
+                level[*v] = level[u] + 1;
+                q.push(*v);
+            }
+        }
+    }
+    return level;
+}
+
+// Edge sementara yang ditulis ke file run saat konversi
+struct EdgeRecord {
+    uint32_t src;
+    uint32_t dest;
+    double weight;
+};
+
+/**
+ * Mengonversi file teks edge list ("src dest [bobot]" per baris, '#' komentar)
+ * ke format biner graf dengan memori terbatas.
+ *
+ * Edge ditampung paling banyak maxEdgesInMemory, diurutkan menurut src lalu
+ * ditulis sebagai run ke file sementara. Setelah itu semua run di-merge
+ * (k-way) dan ditulis berurutan ke section targets/weights. Yang tetap di
+ * memori hanya kamus nama dan derajat per vertex (O(V)), bukan edge (O(E)).
+ */
+bool convertEdgeListToBinary(const std::string& textPath, const std::string& binPath,
+                             size_t maxEdgesInMemory = 1 << 20) {
+    std::ifstream input(textPath);
+    if (!input) {
+        return false;
+    }
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> names;
+    std::vector<uint64_t> degree;
+    std::vector<EdgeRecord> buffer;
+    std::vector<std::string> runPaths;
+    uint64_t numEdges = 0;
+    bool weighted = false;
+
+    auto intern = [&](const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        uint32_t id = (uint32_t)names.size();
+        ids.emplace(name, id);
+        names.push_back(name);
+        degree.push_back(0);
+        return id;
+    };
+    // stable_sort menjaga urutan edge sesuai file untuk src yang sama
+    auto flushRun = [&]() {
+        if (buffer.empty()) {
+            return true;
+        }
+        std::stable_sort(buffer.begin(), buffer.end(),
+                         [](const EdgeRecord& a, const EdgeRecord& b) { return a.src < b.src; });
+        std::string runPath = binPath + ".run" + std::to_string(runPaths.size());
+        std::FILE* run = std::fopen(runPath.c_str(), "wb");
+        if (!run) {
+            return false;
+        }
+        bool ok = std::fwrite(buffer.data(), sizeof(EdgeRecord), buffer.size(), run) == buffer.size();
+        ok = std::fclose(run) == 0 && ok;
+        runPaths.push_back(runPath);
+        buffer.clear();
+        return ok;
+    };
+    auto removeRuns = [&]() {
+        for (const auto& runPath : runPaths) {
+            std::remove(runPath.c_str());
+        }
+    };
+
+    // Tahap 1: baca teks, intern nama, hitung derajat, tulis run terurut
+    buffer.reserve(std::min<size_t>(maxEdgesInMemory, 1 << 20));
+    std::string line, srcName, destName;
+    bool ok = true;
+    while (ok && std::getline(input, line)) {
+        std::istringstream fields(line);
+        double weight = 1.0;
+        if (!(fields >> srcName >> destName) || srcName[0] == '#') {
+            continue;
+        }
+        if (fields >> weight) {
+            weighted = true;
+        }
+        uint32_t u = intern(srcName);
+        uint32_t v = intern(destName);
+        degree[u]++;
+        numEdges++;
+        buffer.push_back({u, v, weight});
+        if (buffer.size() >= maxEdgesInMemory) {
+            ok = flushRun();
+        }
+    }
+    ok = ok && flushRun();
+    std::vector<EdgeRecord>().swap(buffer);
+
+    std::FILE* file = ok ? std::fopen(binPath.c_str(), "wb") : nullptr;
+    if (!file) {
+        removeRuns();
+        return false;
+    }
+    uint64_t nameBytes = 0;
+    for (const auto& name : names) {
+        nameBytes += name.size();
+    }
+    GraphFileHeader h = makeGraphFileHeader(names.size(), numEdges, nameBytes, weighted);
+
+    // Tahap 2: offsets dari derajat, lalu merge run ke targets dan weights
+    std::vector<uint64_t> offsets(names.size() + 1, 0);
+    for (size_t i = 0; i < names.size(); i++) {
+        offsets[i + 1] = offsets[i] + degree[i];
+    }
+    ok = std::fwrite(&h, sizeof(h), 1, file) == 1 &&
+         seekTo(file, h.offsetsPos) &&
+         std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+    std::vector<uint64_t>().swap(offsets);
+
+    struct RunReader {
+        std::FILE* file;
+        EdgeRecord current;
+        bool next() { return std::fread(&current, sizeof(EdgeRecord), 1, file) == 1; }
+    };
+    std::vector<RunReader> runs;
+    auto later = [&](size_t a, size_t b) {
+        // Urut menurut src, lalu nomor run agar urutan file tetap terjaga
+        if (runs[a].current.src != runs[b].current.src) {
+            return runs[a].current.src > runs[b].current.src;
+        }
+        return a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heads(later);
+    for (const auto& runPath : runPaths) {
+        RunReader reader{std::fopen(runPath.c_str(), "rb"), {0, 0, 0.0}};
+        ok = ok && reader.file;
+        runs.push_back(reader);
+        if (reader.file && runs.back().next()) {
+            heads.push(runs.size() - 1);
+        }
+    }
+
+    const size_t CHUNK = 1 << 16;
+    std::vector<uint32_t> targetChunk;
+    std::vector<double> weightChunk;
+    uint64_t written = 0;
+    auto flushChunk = [&]() {
+        bool chunkOk = seekTo(file, h.targetsPos + written * sizeof(uint32_t)) &&
+                       std::fwrite(targetChunk.data(), sizeof(uint32_t), targetChunk.size(), file) == targetChunk.size();
+        if (chunkOk && weighted) {
+            chunkOk = seekTo(file, h.weightsPos + written * sizeof(double)) &&
+                      std::fwrite(weightChunk.data(), sizeof(double), weightChunk.size(), file) == weightChunk.size();
+        }
+        written += targetChunk.size();
+        targetChunk.clear();
+        weightChunk.clear();
+        return chunkOk;
+    };
+    while (ok && !heads.empty()) {
+        size_t r = heads.top();
+        heads.pop();
+        targetChunk.push_back(runs[r].current.dest);
+        weightChunk.push_back(runs[r].current.weight);
+        if (runs[r].next()) {
+            heads.push(r);
+        }
+        if (targetChunk.size() == CHUNK) {
+            ok = flushChunk();
+        }
+    }
+    ok = ok && flushChunk();
+    for (auto& reader : runs) {
+        if (reader.file) {
+            std::fclose(reader.file);
+        }
+    }
+    removeRuns();
+
+    // Tahap 3: section nama
+    ok = ok && writeGraphFileNames(file, h, names);
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+// ===================== Graf dinamis dengan snapshot =====================
+
+// Blok adjacency untuk sekelompok vertex berurutan. Blok tidak pernah diubah
+// setelah dipublikasikan; writer menyalin blok yang disentuh (copy-on-write).
+struct AdjacencyBlock {
+    static const int VERTICES = 64;
+    std::vector<std::string> names;
+    std::vector<std::vector<int>> neighbors;
+};
+
+// Versi graf yang konsisten. Snapshot lama tetap hidup selama masih ada
+// reader yang memegang shared_ptr-nya, lalu dibebaskan otomatis.
+struct GraphSnapshot {
+    uint64_t version = 0;
+    int numVertices = 0;
+    std::vector<std::shared_ptr<const AdjacencyBlock>> blocks;
+
+    const std::vector<int>& neighbors(int u) const {
+        return blocks[u / AdjacencyBlock::VERTICES]->neighbors[u % AdjacencyBlock::VERTICES];
+    }
+    const std::string& getVertexName(int u) const {
+        return blocks[u / AdjacencyBlock::VERTICES]->names[u % AdjacencyBlock::VERTICES];
+    }
+
+    std::vector<int> BFSLevels(int src) const;
+    template <typename Visitor>
+    void DFSVisit(int src, Visitor& visitor) const;
+};
+
+std::vector<int> GraphSnapshot::BFSLevels(int src) const {
+    std::vector<int> level(numVertices, -1);
+    if (src < 0 || src >= numVertices) {
+        return level;
+    }
+    std::queue<int> q;
+    level[src] = 0;
+    q.push(src);
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        for (int v : neighbors(u)) {
+            if (level[v] == -1) {
+                level[v] = level[u] + 1;
+                q.push(v);
+            }
+        }
+    }
+    return level;
+}
+
+template <typename Visitor>
+void GraphSnapshot::DFSVisit(int src, Visitor& visitor) const {
+    if (src < 0 || src >= numVertices) {
+        return;
+    }
+    std::vector<uint64_t> visited((numVertices + 63) / 64, 0);
+    std::vector<std::pair<int, size_t>> stack;
+    setBit(visited, src);
+    visitor.preVisit(src);
+    stack.push_back({src, 0});
+    while (!stack.empty()) {
+        int u = stack.back().first;
+        size_t k = stack.back().second;
+        const std::vector<int>& adj = neighbors(u);
+        if (k < adj.size()) {
+            stack.back().second = k + 1;
+            int v = adj[k];
+            if (!testBit(visited, v)) {
+                setBit(visited, v);
+                visitor.preVisit(v);
+                stack.push_back({v, 0});
+            }
+        } else {
+            visitor.postVisit(u);
+            stack.pop_back();
+        }
+    }
+}
+
+// Perubahan edge dalam satu batch
+struct EdgeUpdate {
+    std::string src;
+    std::string dest;
+    bool insert; // true = tambah edge, false = hapus edge
+};
+
+/**
+ * Graf dinamis dengan publikasi gaya RCU.
+ *
+ * Writer menerapkan satu batch sekaligus: menyalin tabel blok dan blok yang
+ * disentuh, lalu mempublikasikan snapshot baru secara atomik. Reader cukup
+ * mengambil snapshot() dan menjalankan BFS/DFS tanpa lock; mereka tidak
+ * pernah melihat batch yang setengah jadi dan writer tidak menunggu reader.
+ */
+class DynamicGraph {
+private:
+    std::shared_ptr<const GraphSnapshot> current; // dibaca/ditulis lewat atomic_load/atomic_store
+    std::mutex writerMutex;                       // satu writer pada satu waktu
+    mutable std::shared_mutex namesMutex;         // melindungi vertexId
+    std::unordered_map<std::string, int> vertexId;
+
+public:
+    DynamicGraph() : current(std::make_shared<GraphSnapshot>()) {}
+
+    // Snapshot terbaru; aman dipanggil dari banyak thread
+    std::shared_ptr<const GraphSnapshot> snapshot() const { return std::atomic_load(&current); }
+
+    // Id vertex (-1 jika belum ada). Vertex baru mungkin belum ada di snapshot lama.
+    int getVertexId(const std::string& name) const;
+
+    void applyBatch(const std::vector<EdgeUpdate>& batch);
+};
+
+int DynamicGraph::getVertexId(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(namesMutex);
+    auto it = vertexId.find(name);
+    return it == vertexId.end() ? -1 : it->second;
+}
+
+void DynamicGraph::applyBatch(const std::vector<EdgeUpdate>& batch) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    std::shared_ptr<const GraphSnapshot> old = std::atomic_load(&current);
+    auto next = std::make_shared<GraphSnapshot>(*old); // salin tabel blok saja
+    next->version = old->version + 1;
+
+    // Blok yang sudah disalin di batch ini boleh diubah langsung
+    std::vector<std::shared_ptr<AdjacencyBlock>> writable(next->blocks.size());
+    auto blockFor = [&](int u) -> AdjacencyBlock& {
+        size_t b = u / AdjacencyBlock::VERTICES;
+        if (b >= next->blocks.size()) {
+            next->blocks.resize(b + 1);
+            writable.resize(b + 1);
+        }
+        if (!writable[b]) {
+            writable[b] = next->blocks[b] ? std::make_shared<AdjacencyBlock>(*next->blocks[b])
+                                          : std::make_shared<AdjacencyBlock>();
+            next->blocks[b] = writable[b];
+        }
+        return *writable[b];
+    };
+    auto intern = [&](const std::string& name) {
+        {
+            std::shared_lock<std::shared_mutex> names(namesMutex);
+            auto it = vertexId.find(name);
+            if (it != vertexId.end()) {
+                return it->second;
+            }
+        }
+        int id = next->numVertices++;
+        AdjacencyBlock& block = blockFor(id);
+        block.names.push_back(name);
+        block.neighbors.emplace_back();
+        std::unique_lock<std::shared_mutex> names(namesMutex);
+        vertexId.emplace(name, id);
+        return id;
+    };
+
+    for (const auto& update : batch) {
+        int u = update.insert ? intern(update.src) : getVertexId(update.src);
+        int v = update.insert ? intern(update.dest) : getVertexId(update.dest);
+        if (u < 0 || v < 0) {
+            continue; // menghapus edge dari vertex yang tidak ada
+        }
+        std::vector<int>& adj = blockFor(u).neighbors[u % AdjacencyBlock::VERTICES];
+        if (update.insert) {
+            adj.push_back(v);
+        } else {
+            auto it = std::find(adj.begin(), adj.end(), v);
+            if (it != adj.end()) {
+                adj.erase(it);
+            }
+        }
+    }
+    std::atomic_store(&current, std::shared_ptr<const GraphSnapshot>(next));
+}
+
+// Membuat edge graf power-law sintetis dengan generator R-MAT (2^scale vertex)
+static std::vector<std::pair<int, int>> generatePowerLawEdges(int scale, int edgeFactor, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    const double a = 0.57, b = 0.19, c = 0.19;
+    long long numEdges = (1LL << scale) * edgeFactor;
+
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(numEdges);
+    for (long long e = 0; e < numEdges; e++) {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            double r = dist(rng);
+            if (r < a) {
+                // kuadran kiri atas
+            } else if (r < a + b) {
+                v |= 1 << bit;
+            } else if (r < a + b + c) {
+                u |= 1 << bit;
+            } else {
+                u |= 1 << bit;
+                v |= 1 << bit;
+            }
+        }
+        edges.push_back({u, v});
+    }
+    return edges;
+}
+
+// Benchmark BFS pada graf power-law dengan ukuran bertambah (scale 20 = 1M
+// vertex, 32M edge berarah). Dua hal diukur terpisah: keuntungan algoritma
+// (BFS direction-optimizing satu thread vs BFS top-down serial) dan scaling
+// thread (direction-optimizing 1 thread vs t thread). Waktu = terbaik dari 3.
+void benchmarkParallelBFS(int minScale = 16, int maxScale = 20) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> threadCounts;
+    for (unsigned t = 1; t < cores; t *= 2) {
+        threadCounts.push_back((int)t);
+    }
+    threadCounts.push_back((int)cores);
+
+    auto bestMs = [](const std::function<void()>& run) {
+        double best = std::numeric_limits<double>::infinity();
+        for (int r = 0; r < 3; r++) {
+            auto t0 = std::chrono::steady_clock::now();
+            run();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+        return best;
+    };
+
+    std::cout << "scale,vertices,edges,topdown_ms,diropt_ms,diropt_vs_topdown,threads,parallel_ms,thread_speedup,match\n";
+    for (int scale = minScale; scale <= maxScale; scale += 2) {
+        // Edge dua arah agar sebagian besar graf terjangkau dari hub
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(2 * (8LL << scale));
+        std::vector<int> degree(1 << scale, 0);
+        for (const auto& e : generatePowerLawEdges(scale, 8, 42 + scale)) {
+            edges.push_back(e);
+            edges.push_back({e.second, e.first});
+            degree[e.first]++;
+        }
+        Graph g;
+        g.loadEdges(1 << scale, edges);
+        std::string start = std::to_string(std::max_element(degree.begin(), degree.end()) - degree.begin());
+
+        std::vector<int> serial = g.BFSLevels(start);
+        double topDownMs = bestMs([&] { g.BFSLevels(start); });
+        double dirOptMs = bestMs([&] { g.parallelBFSLevels(start, 1); });
+        for (int threads : threadCounts) {
+            bool same = g.parallelBFSLevels(start, threads) == serial;
+            double parallelMs = threads == 1 ? dirOptMs : bestMs([&] { g.parallelBFSLevels(start, threads); });
+            std::cout << scale << "," << g.getVertexCount() << "," << edges.size() << "," << topDownMs << ","
+                      << dirOptMs << "," << topDownMs / dirOptMs << "," << threads << "," << parallelMs << ","
+                      << dirOptMs / parallelMs << "," << (same ? "ya" : "TIDAK") << "\n";
+        }
+    }
+}
+
+// Benchmark Dijkstra, A* dan many-to-many pada graf grid mirip jaringan jalan.
+// 1000 x 1000 = 1M vertex dan ~4M edge berarah, seukuran jaringan jalan satu
+// provinsi/negara bagian (misalnya DIMACS Florida: 1.07M vertex, 2.7M edge).
+void benchmarkShortestPaths(int width = 1000, int height = 1000) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> roadCost(1.0, 3.0); // biaya >= jarak grid
+    std::vector<std::pair<int, int>> edges;
+    std::vector<double> weights;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            for (int next : {x + 1 < width ? cell + 1 : -1, y + 1 < height ? cell + width : -1}) {
+                if (next >= 0) {
+                    double w = roadCost(rng);
+                    edges.push_back({cell, next});
+                    edges.push_back({next, cell});
+                    weights.push_back(w);
+                    weights.push_back(w);
+                }
+            }
+        }
+    }
+    Graph road;
+    road.loadEdges(width * height, edges, weights);
+    // Id vertex = y * width + x, jadi heuristic Manhattan bisa dihitung dari id
+    // (admissible karena biaya >= 1)
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<double> all = road.dijkstra("0");
+    auto t1 = std::chrono::steady_clock::now();
+    double fullMs = ms(t0, t1);
+    std::cout << "Grid " << width << "x" << height << " (" << road.getVertexCount() << " vertex): Dijkstra penuh "
+              << fullMs << " ms\n";
+
+    const int queries = 20;
+    std::uniform_int_distribution<int> cellDist(0, width * height - 1);
+    double dijkstraMs = 0, aStarMs = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; q++) {
+        int s = cellDist(rng), t = cellDist(rng);
+        auto q0 = std::chrono::steady_clock::now();
+        double plain = road.aStar(std::to_string(s), std::to_string(t), [](int) { return 0.0; });
+        auto q1 = std::chrono::steady_clock::now();
+        double guided = road.aStar(std::to_string(s), std::to_string(t), [&](int v) {
+            return (double)(std::abs(v % width - t % width) + std::abs(v / width - t / width));
+        });
+        auto q2 = std::chrono::steady_clock::now();
+        dijkstraMs += ms(q0, q1);
+        aStarMs += ms(q1, q2);
+        if (std::abs(plain - guided) > 1e-9) {
+            mismatches++;
+        }
+    }
+    std::cout << "Point-to-point rata-rata: Dijkstra " << dijkstraMs / queries << " ms, A* "
+              << aStarMs / queries << " ms, selisih hasil: " << mismatches << "\n";
+
+    // Waktu dinyatakan juga dalam Dijkstra penuh; pencarian per vertex di sisi
+    // yang lebih kecil butuh sekitar min(|S|, |T|) pencarian. Titik "acak"
+    // tersebar di seluruh grid, titik "lokal" berada di kotak 1/5 sisi grid
+    // (satu kota). Dua baris pertama dicocokkan dengan Dijkstra biasa.
+    struct Shape {
+        int sources, targets;
+        bool local;
+    };
+    for (Shape shape : {Shape{16, 16, false}, Shape{64, 8, false}, Shape{16, 16, true}, Shape{64, 64, true}}) {
+        int side = shape.local ? std::max(1, width / 5) : width, rows = shape.local ? std::max(1, height / 5) : height;
+        std::uniform_int_distribution<int> xDist(0, side - 1), yDist(0, rows - 1);
+        auto pick = [&]() {
+            return std::to_string((yDist(rng) + (height - rows) / 2) * width + xDist(rng) + (width - side) / 2);
+        };
+        std::vector<std::string> sources, targets;
+        for (int i = 0; i < shape.sources; i++) {
+            sources.push_back(pick());
+        }
+        for (int i = 0; i < shape.targets; i++) {
+            targets.push_back(pick());
+        }
+        auto m0 = std::chrono::steady_clock::now();
+        std::vector<std::vector<double>> matrix = road.distanceMatrix(sources, targets);
+        auto m1 = std::chrono::steady_clock::now();
+        int wrong = 0;
+        for (int i = 0; i < 2; i++) {
+            std::vector<double> reference = road.dijkstra(sources[i]);
+            for (int j = 0; j < shape.targets; j++) {
+                wrong += std::abs(reference[road.getVertexId(targets[j])] - matrix[i][j]) > 1e-9;
+            }
+        }
+        std::cout << "Many-to-many " << shape.sources << "x" << shape.targets << (shape.local ? " lokal: " : " acak: ")
+                  << ms(m0, m1) << " ms = " << ms(m0, m1) / fullMs << " Dijkstra penuh (per vertex: "
+                  << std::min(shape.sources, shape.targets) << "), salah: " << wrong << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Ukuran benchmark bisa diatur, misalnya: ./graph 20 1000 (scale R-MAT
+    // terbesar untuk BFS, sisi grid jaringan jalan). Default kecil agar demo cepat.
+    int maxScale = argc > 1 ? std::atoi(argv[1]) : 14;
+    int gridSide = argc > 2 ? std::atoi(argv[2]) : 300;
+
+    // Contoh adjacency matrix
+    Graph gm(5);
+    gm.addEdgeMatrix(0, 1);
+    gm.addEdgeMatrix(0, 2);
+    gm.addEdgeMatrix(1, 3);
+    gm.addEdgeMatrix(2, 4);
+    std::cout << "Adjacency Matrix:\n";
+    gm.printAdjMatrix();
+    std::cout << "BFS Matrix dari 0:";
+    for (int v : gm.BFSMatrix(0)) {
+        std::cout << " " << v;
+    }
+    std::cout << "\n\n";
+
+    // Contoh adjacency list
+    Graph gl;
+    gl.addEdgeList("A", "B");
+    gl.addEdgeList("A", "C");
+    gl.addEdgeList("B", "D");
+    gl.addEdgeList("C", "D");
+    gl.addEdgeList("D", "E");
+    std::cout << "Adjacency List:\n";
+    gl.printAdjList();
+
+    std::cout << "BFS List dari A:";
+    for (const auto& v : gl.BFSList("A")) {
+        std::cout << " " << v;
+    }
+    std::cout << "\nDFS List dari A:";
+    for (const auto& v : gl.DFSList("A")) {
+        std::cout << " " << v;
+    }
+    std::cout << "\nLevel BFS paralel dari A:";
+    std::vector<int> level = gl.parallelBFSLevels("A");
+    for (int id = 0; id < gl.getVertexCount(); id++) {
+        std::cout << " " << gl.getVertexName(id) << "=" << level[id];
+    }
+    std::cout << "\n\n";
+
+    // DFS streaming: vertex dicetak saat ditemukan dan saat selesai
+    struct PrintVisitor {
+        const Graph& graph;
+        void preVisit(int id) { std::cout << " +" << graph.getVertexName(id); }
+        void postVisit(int id) { std::cout << " -" << graph.getVertexName(id); }
+    } printer{gl};
+    std::cout << "DFS streaming dari A:";
+    gl.DFSVisit("A", printer);
+
+    std::vector<std::string> order;
+    std::cout << "\nTopological sort:";
+    if (gl.topologicalSort(order)) {
+        for (const auto& v : order) {
+            std::cout << " " << v;
+        }
+    }
+
+    Graph gc;
+    gc.addEdgeList("A", "B");
+    gc.addEdgeList("B", "C");
+    gc.addEdgeList("C", "A");
+    gc.addEdgeList("C", "D");
+    gc.addEdgeList("D", "E");
+    gc.addEdgeList("E", "D");
+    std::vector<int> componentOf;
+    int count = gc.stronglyConnectedComponents(componentOf);
+    std::cout << "\nSCC (" << count << " komponen):";
+    for (int id = 0; id < gc.getVertexCount(); id++) {
+        std::cout << " " << gc.getVertexName(id) << "=" << componentOf[id];
+    }
+    std::cout << "\nTopological sort graf bersiklus: "
+              << (gc.topologicalSort(order) ? "berhasil" : "gagal (ada siklus)") << "\n";
+
+    // Graf rantai yang sangat dalam tidak lagi membuat stack overflow
+    Graph chain;
+    const int depthChain = 200000;
+    for (int i = 0; i < depthChain; i++) {
+        chain.addEdgeList(std::to_string(i), std::to_string(i + 1));
+    }
+    std::cout << "DFS rantai " << depthChain << " edge: "
+              << chain.DFSList("0").size() << " vertex dikunjungi\n\n";
+
+    // Jalur terpendek berbobot
+    Graph gw;
+    gw.addEdgeList("A", "B", 4);
+    gw.addEdgeList("A", "C", 1);
+    gw.addEdgeList("C", "B", 2);
+    gw.addEdgeList("B", "D", 1);
+    gw.addEdgeList("C", "D", 5);
+    std::vector<double> dist = gw.dijkstra("A");
+    std::cout << "Dijkstra dari A:";
+    for (int id = 0; id < gw.getVertexCount(); id++) {
+        std::cout << " " << gw.getVertexName(id) << "=" << dist[id];
+    }
+    std::vector<std::string> path;
+    double length = gw.aStar("A", "D", [](int) { return 0.0; }, &path);
+    std::cout << "\nA* A -> D (" << length << "):";
+    for (const auto& v : path) {
+        std::cout << " " << v;
+    }
+    std::cout << "\n\n";
+
+    benchmarkShortestPaths(gridSide, gridSide);
+    std::cout << "\n";
+
+    // Simpan ke format biner lalu muat kembali lewat mmap
+    if (gw.saveBinary("graph_demo.bin")) {
+        MappedGraph mapped;
+        if (mapped.open("graph_demo.bin")) {
+            std::cout << "Graf biner: " << mapped.getVertexCount() << " vertex, "
+                      << mapped.getEdgeCount() << " edge, berbobot: " << (mapped.isWeighted() ? "ya" : "tidak")
+                      << "\nTetangga A:";
+            uint32_t a = (uint32_t)mapped.getVertexId("A");
+            for (const uint32_t* v = mapped.neighborsBegin(a); v != mapped.neighborsEnd(a); ++v) {
+                std::cout << " " << mapped.getVertexName(*v);
+            }
+            std::cout << "\n";
+        }
+    }
+    std::remove("graph_demo.bin");
+
+    // Konversi edge list teks ke format biner dengan run kecil (memori terbatas)
+    {
+        std::ofstream text("graph_demo.txt");
+        std::vector<std::pair<int, int>> edges = generatePowerLawEdges(14, 8, 99);
+        Graph reference;
+        for (const auto& e : edges) {
+            text << e.first << " " << e.second << "\n";
+            reference.addEdgeList(std::to_string(e.first), std::to_string(e.second));
+        }
+        text.close();
+
+        auto c0 = std::chrono::steady_clock::now();
+        bool converted = convertEdgeListToBinary("graph_demo.txt", "graph_demo.bin", 10000);
+        auto c1 = std::chrono::steady_clock::now();
+        MappedGraph mapped;
+        bool opened = converted && mapped.open("graph_demo.bin");
+        auto c2 = std::chrono::steady_clock::now();
+        if (opened) {
+            std::string start = std::to_string(edges[0].first);
+            std::vector<int> expected = reference.BFSLevels(start);
+            std::vector<int> actual = mapped.BFSLevels(start);
+            bool same = true;
+            for (int id = 0; id < reference.getVertexCount(); id++) {
+                int64_t mid = mapped.getVertexId(reference.getVertexName(id));
+                same = same && mid >= 0 && actual[mid] == expected[id];
+            }
+            std::cout << "Konversi " << mapped.getEdgeCount() << " edge: "
+                      << std::chrono::duration<double, std::milli>(c1 - c0).count() << " ms, mmap load: "
+                      << std::chrono::duration<double, std::milli>(c2 - c1).count() << " ms, BFS sama: "
+                      << (same ? "ya" : "TIDAK") << "\n\n";
+        }
+        std::remove("graph_demo.txt");
+        std::remove("graph_demo.bin");
+    }
+
+    // Graf dinamis: writer menerapkan batch sementara reader menjalankan BFS.
+    // Setiap batch menambah/menghapus edge berpasangan (u->v dan v->u), jadi
+    // snapshot yang konsisten selalu simetris.
+    {
+        DynamicGraph dynamic;
+        std::vector<EdgeUpdate> seed;
+        for (int i = 0; i < 1000; i++) {
+            std::string a = std::to_string(i), b = std::to_string((i + 1) % 1000);
+            seed.push_back({a, b, true});
+            seed.push_back({b, a, true});
+        }
+        dynamic.applyBatch(seed);
+
+        std::atomic<bool> done(false);
+        std::atomic<long long> reads(0), torn(0);
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 2; r++) {
+            readers.emplace_back([&]() {
+                while (!done.load()) {
+                    std::shared_ptr<const GraphSnapshot> snap = dynamic.snapshot();
+                    snap->BFSLevels(0);
+                    for (int u = 0; u < snap->numVertices; u++) {
+                        for (int v : snap->neighbors(u)) {
+                            const std::vector<int>& back = snap->neighbors(v);
+                            if (std::count(back.begin(), back.end(), u) != std::count(snap->neighbors(u).begin(),
+                                                                                      snap->neighbors(u).end(), v)) {
+                                torn++;
+                            }
+                        }
+                    }
+                    reads++;
+                }
+            });
+        }
+
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> pick(0, 1999);
+        std::vector<std::pair<std::string, std::string>> added;
+        for (int round = 0; round < 200; round++) {
+            std::vector<EdgeUpdate> batch;
+            for (int k = 0; k < 20; k++) {
+                std::string a = std::to_string(pick(rng)), b = std::to_string(pick(rng));
+                batch.push_back({a, b, true});
+                batch.push_back({b, a, true});
+                added.push_back({a, b});
+            }
+            for (int k = 0; k < 10 && !added.empty(); k++) {
+                auto e = added.back();
+                added.pop_back();
+                batch.push_back({e.first, e.second, false});
+                batch.push_back({e.second, e.first, false});
+            }
+            dynamic.applyBatch(batch);
+        }
+        done = true;
+        for (auto& t : readers) {
+            t.join();
+        }
+        std::shared_ptr<const GraphSnapshot> last = dynamic.snapshot();
+        std::cout << "Graf dinamis: versi " << last->version << ", " << last->numVertices << " vertex, "
+                  << reads.load() << " snapshot dibaca, tidak konsisten: " << torn.load() << "\n\n";
+    }
+
+    benchmarkParallelBFS(std::min(12, maxScale), maxScale);
+    return 0;
+}
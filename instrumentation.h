@@ -0,0 +1,559 @@
+/**
+ * @file instrumentation.h
+ * @brief Tracing dan metrik ringan untuk hot path semua program
+ *
+ * Dipakai lewat makro:
+ *     TRACE_SCOPE("nama");          // span: durasi masuk trace + histogram latensi
+ *     TRACE_COUNT("nama");          // counter +1
+ *     TRACE_COUNT_ADD("nama", n);   // counter +n
+ *     TRACE_VALUE("nama", nilai);   // histogram nilai bebas (log2 bucket)
+ *     TRACE_START_EXPORT("trace.json");  // thread eksportir Chrome trace JSON
+ *     TRACE_STOP_EXPORT(std::cerr);      // tutup file trace, cetak ringkasan metrik
+ *
+ * Tanpa -DENABLE_TRACING semua makro menjadi ((void)0) dan header ini tidak
+ * meng-include apa pun, jadi tidak ada biaya sama sekali.
+ *
+ * Dengan -DENABLE_TRACING setiap thread menulis ke state miliknya sendiri
+ * (counter, histogram, ring buffer event) tanpa lock dan tanpa operasi atomic
+ * read-modify-write; hanya load/store relaxed agar eksportir boleh membaca
+ * bersamaan. Hot path tidak pernah mengambil Registry::lock: ring berukuran
+ * tetap TRACE_RING_EVENTS dialokasikan saat thread pertama kali mencatat, dan
+ * histogram sebuah metrik dialokasikan sekali per thread lalu diterbitkan
+ * lewat pointer atomic. Lock hanya diambil saat call site pertama kali
+ * dijalankan serta saat thread mulai dan selesai; di situ thread bisa
+ * menunggu eksportir yang sedang menulis file.
+ *
+ * Memori per thread sekitar 100 KB: counter (2 KB), ring 4096 event (96 KB)
+ * dan histogram 520 byte per metrik yang dipakai thread itu. Ring yang penuh
+ * tidak diperbesar; event dibuang dan dihitung di trace.dropped_events.
+ * Eksportir dibangunkan saat ring terisi setengah. Saat thread selesai,
+ * metriknya dilipat ke total registry dan state-nya (termasuk ring dan
+ * histogram) dipakai ulang oleh thread berikutnya.
+ *
+ * Span disampel: setiap span menambah counter metriknya, tetapi hanya satu
+ * dari TRACE_SAMPLE_EVERY span per metrik yang membaca jam (dua kali, awal
+ * dan akhir), mengisi histogram dan menulis event. Span lain tidak membaca
+ * jam sama sekali. Di VM benchmark satu rdtsc saja sekitar 22 ns, jadi span
+ * yang selalu diukur tidak mungkin di bawah 20 ns; dengan sampel 1 dari 8
+ * dan eksportir berjalan trace.scope terukur 13-18 ns rata-rata. Ringkasan
+ * mencetak count (semua span) dan samples (span yang diukur).
+ * -DTRACE_SAMPLE_EVERY=1 mengukur setiap span. Counter sekitar 2 ns.
+ */
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#ifdef ENABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Kapasitas ring per thread untuk event yang belum diekspor (pangkat dua)
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS (1 << 12)
+#endif
+
+// Satu dari sekian span per metrik yang diukur (pangkat dua)
+#ifndef TRACE_SAMPLE_EVERY
+#define TRACE_SAMPLE_EVERY 8
+#endif
+
+namespace trace {
+
+const uint32_t MAX_METRICS = 256;
+const uint32_t BUCKETS = 65;        // bucket b berisi nilai dengan bit tertinggi di posisi b-1
+const uint64_t RING_EVENTS = TRACE_RING_EVENTS;
+const uint64_t SAMPLE_EVERY = TRACE_SAMPLE_EVERY;
+
+static_assert(RING_EVENTS >= 2 && (RING_EVENTS & (RING_EVENTS - 1)) == 0, "TRACE_RING_EVENTS harus pangkat dua");
+static_assert(SAMPLE_EVERY >= 1 && (SAMPLE_EVERY & (SAMPLE_EVERY - 1)) == 0, "TRACE_SAMPLE_EVERY harus pangkat dua");
+
+// Detak jam: TSC di x86, selain itu steady_clock dalam nanodetik
+inline uint64_t now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+inline uint64_t steadyNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Event {
+    uint64_t start;
+    uint64_t duration;
+    uint32_t metric;
+};
+
+// State milik satu thread; hanya thread pemilik yang menulis counter, bucket,
+// head dan pointer histogram (sekali, dengan release). Eksportir membaca
+// sambil memegang Registry::lock dan hanya menulis tail.
+struct ThreadState {
+    uint32_t tid = 0;
+    bool active = false;
+    std::atomic<uint64_t> counters[MAX_METRICS];
+    std::atomic<std::atomic<uint64_t>*> histograms[MAX_METRICS]; // nullptr sampai dipakai
+    std::unique_ptr<Event[]> ring{new Event[RING_EVENTS]};
+    std::atomic<uint64_t> head{0}; // ditulis pemilik
+    std::atomic<uint64_t> tail{0}; // ditulis eksportir
+    std::atomic<uint64_t> dropped{0};
+
+    ThreadState() {
+        for (auto& h : histograms) {
+            h.store(nullptr, std::memory_order_relaxed);
+        }
+        reset();
+    }
+
+    ~ThreadState() {
+        for (auto& h : histograms) {
+            delete[] h.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Mengosongkan metrik; histogram yang sudah ada dipertahankan untuk
+    // thread berikutnya. Dipanggil sambil memegang Registry::lock.
+    void reset() {
+        for (auto& c : counters) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        for (auto& h : histograms) {
+            if (std::atomic<uint64_t>* buckets = h.load(std::memory_order_relaxed)) {
+                for (uint32_t b = 0; b < BUCKETS; b++) {
+                    buckets[b].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct MetricInfo {
+    std::string name;
+    bool isSpan;
+};
+
+// Eksportir aktif; dibaca hot path tanpa melewati Registry::instance()
+inline std::atomic<bool> exporting{false};
+
+// State global: daftar metrik, state setiap thread (aktif maupun yang
+// menunggu dipakai ulang) dan total metrik dari thread yang sudah selesai
+struct Registry {
+    std::mutex lock;
+    std::vector<MetricInfo> metrics;
+    std::vector<std::unique_ptr<ThreadState>> threads;
+    std::vector<ThreadState*> freeStates;
+    uint32_t nextTid = 1;
+    std::vector<uint64_t> retiredCounters = std::vector<uint64_t>(MAX_METRICS);
+    std::vector<std::vector<uint64_t>> retiredHistograms = std::vector<std::vector<uint64_t>>(MAX_METRICS);
+    uint64_t retiredDropped = 0;
+    uint64_t startTicks = now();
+    uint64_t startNs = steadyNs();
+
+    // Exporter
+    std::thread exporter;
+    std::condition_variable wake;
+    FILE* traceFile = nullptr;
+    bool firstEvent = true;
+
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    // Kalibrasi detak -> nanodetik dari waktu sejak registry dibuat
+    double nsPerTick() const {
+        uint64_t ticks = now() - startTicks;
+        uint64_t ns = steadyNs() - startNs;
+        return ticks ? (double)ns / ticks : 1.0;
+    }
+
+    // Memindahkan event satu thread ke file trace; pemanggil memegang lock
+    void drain(ThreadState& state, double scale) {
+        uint64_t tail = state.tail.load(std::memory_order_relaxed);
+        uint64_t head = state.head.load(std::memory_order_acquire);
+        for (; tail < head; tail++) {
+            const Event& e = state.ring[tail & (RING_EVENTS - 1)];
+            if (traceFile) {
+                std::fprintf(traceFile,
+                             "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                             firstEvent ? "" : ",", metrics[e.metric].name.c_str(), state.tid,
+                             (double)(e.start - startTicks) * scale / 1000.0, (double)e.duration * scale / 1000.0);
+                firstEvent = false;
+            }
+        }
+        state.tail.store(tail, std::memory_order_release);
+    }
+
+    void drainAll() {
+        double scale = nsPerTick();
+        for (auto& state : threads) {
+            drain(*state, scale);
+        }
+        if (traceFile) {
+            std::fflush(traceFile);
+        }
+    }
+
+    // Menghentikan dan menunggu eksportir, menulis event tersisa dan menutup
+    // file trace; aman dipanggil berulang
+    void stopExporter() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!exporting.load(std::memory_order_relaxed)) {
+                return;
+            }
+            exporting.store(false, std::memory_order_relaxed);
+        }
+        wake.notify_all();
+        exporter.join();
+        std::lock_guard<std::mutex> guard(lock);
+        drainAll();
+        std::fputs("\n]}\n", traceFile);
+        std::fclose(traceFile);
+        traceFile = nullptr;
+    }
+
+    // Program yang keluar tanpa TRACE_STOP_EXPORT tetap mendapat file trace
+    // yang lengkap, dan std::thread yang masih joinable tidak memicu terminate
+    ~Registry() { stopExporter(); }
+};
+
+// Dipanggil sekali per call site (lewat static lokal di makro)
+inline uint32_t registerMetric(const char* name, bool isSpan) {
+    Registry& r = Registry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for (uint32_t i = 0; i < r.metrics.size(); i++) {
+        if (r.metrics[i].name == name && r.metrics[i].isSpan == isSpan) {
+            return i;
+        }
+    }
+    if (r.metrics.size() >= MAX_METRICS) {
+        return MAX_METRICS - 1; // metrik terakhir menampung kelebihan
+    }
+    r.metrics.push_back({name, isSpan});
+    return (uint32_t)r.metrics.size() - 1;
+}
+
+// Mengambil state bebas (atau membuat yang baru) untuk thread pemanggil
+inline ThreadState* registerThread() {
+    Registry& r = Registry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    ThreadState* state;
+    if (!r.freeStates.empty()) {
+        state = r.freeStates.back();
+        r.freeStates.pop_back();
+    } else {
+        r.threads.push_back(std::make_unique<ThreadState>());
+        state = r.threads.back().get();
+    }
+    state->tid = r.nextTid++;
+    state->active = true;
+    return state;
+}
+
+// Melipat metrik thread yang selesai ke total registry, lalu menyimpan
+// state-nya untuk thread berikutnya
+inline void retireThread(ThreadState* state) {
+    Registry& r = Registry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.drain(*state, r.nsPerTick());
+    for (uint32_t m = 0; m < MAX_METRICS; m++) {
+        r.retiredCounters[m] += state->counters[m].load(std::memory_order_relaxed);
+        if (std::atomic<uint64_t>* buckets = state->histograms[m].load(std::memory_order_acquire)) {
+            std::vector<uint64_t>& retired = r.retiredHistograms[m];
+            retired.resize(BUCKETS);
+            for (uint32_t b = 0; b < BUCKETS; b++) {
+                retired[b] += buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    r.retiredDropped += state->dropped.load(std::memory_order_relaxed);
+    state->reset();
+    state->active = false;
+    r.freeStates.push_back(state);
+}
+
+// Pointer state thread ini; inisialisasi konstan sehingga hot path tidak
+// melewati guard thread_local
+inline thread_local ThreadState* currentState = nullptr;
+inline thread_local bool threadRetired = false;
+
+struct ThreadSlot {
+    ThreadState* state = nullptr;
+    ~ThreadSlot() {
+        if (state) {
+            retireThread(state);
+        }
+        currentState = nullptr;
+        threadRetired = true;
+    }
+};
+
+inline ThreadState* attachThread() {
+    if (threadRetired) {
+        // Span dari destruktor thread_local lain setelah slot dihancurkan:
+        // state ini tidak lagi bisa dikembalikan dan tetap aktif
+        return currentState = registerThread();
+    }
+    static thread_local ThreadSlot slot;
+    slot.state = registerThread();
+    return currentState = slot.state;
+}
+
+inline ThreadState& threadState() {
+    ThreadState* state = currentState;
+    return state ? *state : *attachThread();
+}
+
+// Penambahan oleh satu penulis: load + store relaxed, tanpa lock prefix
+inline void bump(std::atomic<uint64_t>& slot, uint64_t n) {
+    slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline uint32_t bucketOf(uint64_t value) {
+#if defined(__GNUC__)
+    return value ? 64 - (uint32_t)__builtin_clzll(value) : 0;
+#else
+    uint32_t b = 0;
+    while (value) {
+        value >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+// Histogram pertama metrik ini di thread pemilik; diterbitkan tanpa lock
+inline std::atomic<uint64_t>* allocateHistogram(ThreadState& state, uint32_t metric) {
+    std::atomic<uint64_t>* buckets = new std::atomic<uint64_t>[BUCKETS];
+    for (uint32_t b = 0; b < BUCKETS; b++) {
+        buckets[b].store(0, std::memory_order_relaxed);
+    }
+    state.histograms[metric].store(buckets, std::memory_order_release);
+    return buckets;
+}
+
+inline std::atomic<uint64_t>* histogramOf(ThreadState& state, uint32_t metric) {
+    std::atomic<uint64_t>* buckets = state.histograms[metric].load(std::memory_order_relaxed);
+    return buckets ? buckets : allocateHistogram(state, metric);
+}
+
+inline void wakeExporter() {
+    Registry::instance().wake.notify_one();
+}
+
+inline void addCounter(uint32_t metric, uint64_t n) {
+    bump(threadState().counters[metric], n);
+}
+
+inline void recordValue(uint32_t metric, uint64_t value) {
+    bump(histogramOf(threadState(), metric)[bucketOf(value)], 1);
+}
+
+// Mencatat span yang diukur; ring penuh berarti event dibuang
+inline void recordSpan(ThreadState& state, uint32_t metric, uint64_t start, uint64_t end) {
+    uint64_t duration = end - start;
+    bump(histogramOf(state, metric)[bucketOf(duration)], 1);
+    if (!exporting.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    uint64_t head = state.head.load(std::memory_order_relaxed);
+    uint64_t pending = head - state.tail.load(std::memory_order_acquire);
+    if (pending >= RING_EVENTS) {
+        bump(state.dropped, 1);
+        return;
+    }
+    state.ring[head & (RING_EVENTS - 1)] = {start, duration, metric};
+    state.head.store(head + 1, std::memory_order_release);
+    if (pending + 1 == RING_EVENTS / 2) {
+        wakeExporter();
+    }
+}
+
+// Setiap span dihitung; hanya span ke-0, SAMPLE_EVERY, 2*SAMPLE_EVERY, ...
+// per metrik yang membaca jam
+class Span {
+private:
+    ThreadState& state;
+    uint32_t metric;
+    bool sampled;
+    uint64_t start = 0;
+public:
+    explicit Span(uint32_t id) : state(threadState()), metric(id) {
+        uint64_t count = state.counters[id].load(std::memory_order_relaxed);
+        state.counters[id].store(count + 1, std::memory_order_relaxed);
+        sampled = (count & (SAMPLE_EVERY - 1)) == 0;
+        if (sampled) {
+            start = now();
+        }
+    }
+    ~Span() {
+        if (sampled) {
+            recordSpan(state, metric, start, now());
+        }
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+};
+
+inline double nsPerTick() {
+    return Registry::instance().nsPerTick();
+}
+
+// Memindahkan event dari semua ring ke file trace
+inline void drainEvents() {
+    Registry& r = Registry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.drainAll();
+}
+
+// Memulai thread eksportir yang mengosongkan ring setiap intervalMs, atau
+// lebih cepat saat ada ring yang terisi setengah
+inline bool startExport(const char* path, int intervalMs = 50) {
+    Registry& r = Registry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (exporting.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    r.traceFile = std::fopen(path, "w");
+    if (!r.traceFile) {
+        return false;
+    }
+    std::fputs("{\"traceEvents\":[", r.traceFile);
+    r.firstEvent = true;
+    exporting.store(true, std::memory_order_relaxed);
+    r.exporter = std::thread([&r, intervalMs]() {
+        std::unique_lock<std::mutex> lock(r.lock);
+        while (exporting.load(std::memory_order_relaxed)) {
+            r.drainAll();
+            r.wake.wait_for(lock, std::chrono::milliseconds(intervalMs));
+        }
+    });
+    return true;
+}
+
+// Ringkasan metrik semua thread (termasuk yang sudah selesai) sebagai JSON Lines
+inline void writeMetrics(std::ostream& out) {
+    Registry& r = Registry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    double scale = r.nsPerTick();
+    uint64_t dropped = r.retiredDropped;
+    for (auto& state : r.threads) {
+        dropped += state->dropped.load(std::memory_order_relaxed);
+    }
+    for (uint32_t m = 0; m < r.metrics.size(); m++) {
+        uint64_t counter = r.retiredCounters[m], buckets[BUCKETS] = {};
+        if (!r.retiredHistograms[m].empty()) {
+            for (uint32_t b = 0; b < BUCKETS; b++) {
+                buckets[b] = r.retiredHistograms[m][b];
+            }
+        }
+        for (auto& state : r.threads) {
+            counter += state->counters[m].load(std::memory_order_relaxed);
+            if (std::atomic<uint64_t>* histogram = state->histograms[m].load(std::memory_order_acquire)) {
+                for (uint32_t b = 0; b < BUCKETS; b++) {
+                    buckets[b] += histogram[b].load(std::memory_order_relaxed);
+                }
+            }
+        }
+        uint64_t samples = 0;
+        for (uint64_t c : buckets) {
+            samples += c;
+        }
+        out << "{\"metric\":\"" << r.metrics[m].name << "\"";
+        if (counter) {
+            out << ",\"count\":" << counter;
+        }
+        if (samples) {
+            // Persentil = batas atas bucket tempat persentil itu jatuh
+            const char* unit = r.metrics[m].isSpan ? "_ns" : "";
+            double factor = r.metrics[m].isSpan ? scale : 1.0;
+            const double ranks[] = {0.50, 0.90, 0.99};
+            const char* labels[] = {"p50", "p90", "p99"};
+            out << ",\"samples\":" << samples;
+            for (int p = 0; p < 3; p++) {
+                uint64_t target = (uint64_t)(ranks[p] * (samples - 1)), seen = 0;
+                uint32_t b = 0;
+                while (seen + buckets[b] <= target) {
+                    seen += buckets[b++];
+                }
+                double upper = b == 0 ? 0.0 : (double)(b >= 64 ? UINT64_MAX : (1ULL << b) - 1);
+                out << ",\"" << labels[p] << unit << "\":" << (uint64_t)(upper * factor);
+            }
+        }
+        out << "}\n";
+    }
+    out << "{\"metric\":\"trace.dropped_events\",\"count\":" << dropped << ",\"ring_events\":" << RING_EVENTS;
+    if (dropped) {
+        // Eksportir tidak mengejar laju event: perbesar ring atau perpendek interval
+        out << ",\"hint\":\"naikkan TRACE_RING_EVENTS atau perpendek intervalMs startExport\"";
+    }
+    out << "}\n";
+    out.flush();
+}
+
+// Menghentikan eksportir, menulis event tersisa dan menutup file trace
+inline void stopExport(std::ostream& metricsOut) {
+    Registry::instance().stopExporter();
+    writeMetrics(metricsOut);
+}
+
+} // namespace trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(name)                                                                          \
+    static const uint32_t TRACE_CONCAT(traceMetric_, __LINE__) = ::trace::registerMetric(name, true); \
+    ::trace::Span TRACE_CONCAT(traceSpan_, __LINE__)(TRACE_CONCAT(traceMetric_, __LINE__))
+
+#define TRACE_COUNT_ADD(name, n)                                                      \
+    do {                                                                              \
+        static const uint32_t traceMetric = ::trace::registerMetric(name, false);    \
+        ::trace::addCounter(traceMetric, (uint64_t)(n));                              \
+    } while (0)
+
+#define TRACE_COUNT(name) TRACE_COUNT_ADD(name, 1)
+
+#define TRACE_VALUE(name, value)                                                      \
+    do {                                                                              \
+        static const uint32_t traceMetric = ::trace::registerMetric(name, false);    \
+        ::trace::recordValue(traceMetric, (uint64_t)(value));                         \
+    } while (0)
+
+#define TRACE_START_EXPORT(path) ::trace::startExport(path)
+#define TRACE_STOP_EXPORT(out) ::trace::stopExport(out)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_COUNT_ADD(name, n) ((void)0)
+#define TRACE_COUNT(name) ((void)0)
+#define TRACE_VALUE(name, value) ((void)0)
+#define TRACE_START_EXPORT(path) ((void)0)
+#define TRACE_STOP_EXPORT(out) ((void)0)
+
+#endif // ENABLE_TRACING
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,299 @@
+/**
+ * @file record_export.h
+ * @brief Ekspor laporan (CSV / JSON Lines) dengan buffer besar dan formatter angka sendiri
+ *
+ * Dipakai untuk laporan pembayaran (Tugas.cpp) dan pesanan (Class Diagram.cpp):
+ *     exporter::writeFile(path, records, "id,amount\n",
+ *                         [](exporter::RecordBuffer& out, const T& r, size_t i) { ... },
+ *                         threads);
+ *
+ * Setiap record diformat ke RecordBuffer (std::string yang dipakai ulang),
+ * angka ditulis tanpa iostream/snprintf, dan file ditulis per chunk sekitar
+ * CHUNK_BYTES dengan satu fwrite tanpa buffer stdio tambahan. Tidak ada
+ * flush per baris.
+ *
+ * Dengan threads > 1 record dibagi menjadi blok berurutan. Worker
+ * memformat blok ke slot ring (2 slot per worker) dan thread pemanggil
+ * menulis slot sesuai urutan blok, jadi isi file sama persis dengan versi
+ * satu thread.
+ */
+
+#ifndef RECORD_EXPORT_H
+#define RECORD_EXPORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace exporter {
+
+enum class Format { CSV, JSON_LINES };
+
+const size_t CHUNK_BYTES = 1 << 20;        // data yang dikumpulkan sebelum satu fwrite
+const size_t RECORDS_PER_BLOCK = 16384;    // satuan kerja worker pada ekspor paralel
+
+// Buffer teks untuk satu chunk; kapasitas dipertahankan antar chunk
+class RecordBuffer {
+private:
+    std::string data;
+
+    // Pasangan digit "00".."99" agar satu pembagian menghasilkan dua digit
+    static const char* digitPairs() {
+        static const char pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        return pairs;
+    }
+
+    // Menulis magnitude ke akhir text, mengembalikan awal digit
+    static char* formatUnsigned(char* end, uint64_t value) {
+        const char* pairs = digitPairs();
+        char* p = end;
+        while (value >= 100) {
+            const char* pair = pairs + (value % 100) * 2;
+            value /= 100;
+            *--p = pair[1];
+            *--p = pair[0];
+        }
+        if (value >= 10) {
+            *--p = pairs[value * 2 + 1];
+            *--p = pairs[value * 2];
+        } else {
+            *--p = (char)('0' + value);
+        }
+        return p;
+    }
+
+public:
+    explicit RecordBuffer(size_t reserveBytes = CHUNK_BYTES + CHUNK_BYTES / 4) { data.reserve(reserveBytes); }
+
+    const char* bytes() const { return data.data(); }
+    size_t size() const { return data.size(); }
+    void clear() { data.clear(); }
+
+    void put(char c) { data.push_back(c); }
+    void text(std::string_view s) { data.append(s.data(), s.size()); }
+
+    void integer(int64_t value) {
+        char buffer[24];
+        char* end = buffer + sizeof(buffer);
+        uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+        char* p = formatUnsigned(end, magnitude);
+        if (value < 0) {
+            *--p = '-';
+        }
+        data.append(p, end - p);
+    }
+
+    // Angka dengan tepat decimals digit di belakang titik (0..9), dibulatkan
+    // setengah menjauhi nol; nilai di luar jangkauan int64 lewat snprintf
+    void fixed(double value, int decimals = 2) {
+        static const uint64_t powers[] = {1,      10,      100,      1000,      10000,
+                                          100000, 1000000, 10000000, 100000000, 1000000000};
+        decimals = std::max(0, std::min(decimals, 9));
+        double scaled = value * (double)powers[decimals];
+        if (!std::isfinite(scaled) || std::fabs(scaled) >= 9e18) {
+            char buffer[512];
+            int n = std::snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+            data.append(buffer, n > 0 ? std::min((size_t)n, sizeof(buffer) - 1) : 0);
+            return;
+        }
+        int64_t rounded = std::llround(scaled);
+        uint64_t magnitude = rounded < 0 ? 0 - (uint64_t)rounded : (uint64_t)rounded;
+        char buffer[32];
+        char* end = buffer + sizeof(buffer);
+        char* p = end;
+        if (decimals > 0) {
+            uint64_t fraction = magnitude % powers[decimals];
+            for (int d = 0; d < decimals; d++) {
+                *--p = (char)('0' + fraction % 10);
+                fraction /= 10;
+            }
+            *--p = '.';
+        }
+        p = formatUnsigned(p, magnitude / powers[decimals]);
+        if (rounded < 0) {
+            *--p = '-';
+        }
+        data.append(p, end - p);
+    }
+
+    // Field CSV (diapit kutip hanya jika perlu) atau string JSON
+    void field(std::string_view s, Format format) {
+        if (format == Format::CSV) {
+            if (s.find_first_of(",\"\r\n") == std::string_view::npos) {
+                text(s);
+                return;
+            }
+            put('"');
+            for (char c : s) {
+                if (c == '"') {
+                    put('"');
+                }
+                put(c);
+            }
+            put('"');
+            return;
+        }
+        put('"');
+        size_t plain = 0; // awal bagian yang tidak perlu di-escape
+        for (size_t i = 0; i < s.size(); i++) {
+            unsigned char c = (unsigned char)s[i];
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            data.append(s.data() + plain, i - plain);
+            plain = i + 1;
+            switch (c) {
+            case '"': text("\\\""); break;
+            case '\\': text("\\\\"); break;
+            case '\n': text("\\n"); break;
+            case '\r': text("\\r"); break;
+            case '\t': text("\\t"); break;
+            default: {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                text(escaped);
+            }
+            }
+        }
+        data.append(s.data() + plain, s.size() - plain);
+        put('"');
+    }
+};
+
+namespace detail {
+
+inline bool writeChunk(std::FILE* file, const RecordBuffer& buffer, uint64_t& written) {
+    if (buffer.size() == 0) {
+        return true;
+    }
+    written += buffer.size();
+    return std::fwrite(buffer.bytes(), 1, buffer.size(), file) == buffer.size();
+}
+
+} // namespace detail
+
+/**
+ * @brief Menulis semua record ke path (file ditimpa)
+ *
+ * @param header Ditulis sekali di awal (misalnya baris kolom CSV); boleh nullptr
+ * @param format Dipanggil sebagai format(RecordBuffer&, const T&, index record)
+ * @param threads Jumlah thread format; 0 = semua core
+ * @param bytesWritten Jika tidak nullptr, diisi jumlah byte yang ditulis
+ * @return false jika file tidak bisa dibuka atau penulisan gagal
+ */
+template <typename T, typename Formatter>
+bool writeFile(const std::string& path, const std::vector<T>& records, const char* header, Formatter format,
+               unsigned threads = 1, uint64_t* bytesWritten = nullptr) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0); // chunk sudah besar; hindari salinan ke buffer stdio
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t blocks = (records.size() + RECORDS_PER_BLOCK - 1) / RECORDS_PER_BLOCK;
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(blocks, 1));
+
+    uint64_t written = 0;
+    bool ok = true;
+    if (header) {
+        ok = std::fwrite(header, 1, std::strlen(header), file) == std::strlen(header);
+        written += std::strlen(header);
+    }
+
+    if (ok && threads <= 1) {
+        RecordBuffer buffer;
+        for (size_t i = 0; i < records.size() && ok; i++) {
+            format(buffer, records[i], i);
+            if (buffer.size() >= CHUNK_BYTES) {
+                ok = detail::writeChunk(file, buffer, written);
+                buffer.clear();
+            }
+        }
+        ok = ok && detail::writeChunk(file, buffer, written);
+    } else if (ok) {
+        struct Slot {
+            RecordBuffer buffer;
+            size_t block = SIZE_MAX; // blok yang sudah selesai diformat di slot ini
+        };
+        const size_t slotCount = 2 * (size_t)threads;
+        std::vector<Slot> slots(slotCount);
+        std::mutex mutex;
+        std::condition_variable ready, freed;
+        std::atomic<size_t> nextBlock(0);
+        size_t blocksWritten = 0;
+        bool failed = false;
+
+        auto worker = [&]() {
+            for (size_t b = nextBlock.fetch_add(1); b < blocks; b = nextBlock.fetch_add(1)) {
+                Slot& slot = slots[b % slotCount];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    freed.wait(lock, [&] { return failed || b < blocksWritten + slotCount; });
+                    if (failed) {
+                        return;
+                    }
+                }
+                slot.buffer.clear();
+                size_t end = std::min(records.size(), (b + 1) * RECORDS_PER_BLOCK);
+                for (size_t i = b * RECORDS_PER_BLOCK; i < end; i++) {
+                    format(slot.buffer, records[i], i);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slot.block = b;
+                }
+                ready.notify_all();
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++) {
+            pool.emplace_back(worker);
+        }
+        for (size_t b = 0; b < blocks; b++) {
+            Slot& slot = slots[b % slotCount];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&] { return slot.block == b; });
+            }
+            bool chunkOk = detail::writeChunk(file, slot.buffer, written);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                blocksWritten = b + 1;
+                failed = !chunkOk;
+            }
+            freed.notify_all();
+            if (!chunkOk) {
+                ok = false;
+                break;
+            }
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+    }
+
+    ok = std::fclose(file) == 0 && ok;
+    if (bytesWritten) {
+        *bytesWritten = written;
+    }
+    return ok;
+}
+
+} // namespace exporter
+
+#endif // RECORD_EXPORT_H
@@ -1,5 +1,14 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <memory>
+#include "instrumentation.h"
 using namespace std;
 
 // Encapsulation: Class User dengan atribut privat
@@ -21,11 +30,14 @@ public:
     }
 
     void pay(double amount) {
+        TRACE_SCOPE("wallet.pay");
         if (balance >= amount) {
             balance -= amount;
-            cout << "Pembayaran berhasil. Sisa saldo: Rp" << balance << endl;
+            TRACE_COUNT("wallet.debited");
+            cout << "Pembayaran berhasil. Sisa saldo: Rp" << balance << '\n';
         } else {
-            cout << "Saldo tidak cukup!" << endl;
+            TRACE_COUNT("wallet.insufficient");
+            cout << "Saldo tidak cukup!" << '\n';
         }
     }
 };
@@ -67,13 +79,250 @@ public:
 class BikeSharing : public Transport {
 private:
     string station;
+    double latitude, longitude;
+    atomic<int> availableBikes; // Diubah atomic saat sewa/kembali, aman dari banyak thread
 public:
-    BikeSharing(int id, string s) : Transport(id, "Bike", 1), station(s) {}
+    BikeSharing(int id, string s) : BikeSharing(id, s, 0.0, 0.0, 1, 1) {}
+
+    // docks: jumlah dok (kapasitas), bikes: sepeda yang tersedia di awal
+    BikeSharing(int id, string s, double lat, double lon, int docks, int bikes)
+        : Transport(id, "Bike", docks), station(s), latitude(lat), longitude(lon), availableBikes(bikes) {}
+
     void getSchedule() const override {
-        cout << "Sepeda tersedia di stasiun " << station << endl;
+        cout << "Sepeda tersedia di stasiun " << station << ": " << getAvailableBikes() << "/" << capacity << endl;
+    }
+
+    // Mengambil satu sepeda; false jika stasiun kosong
+    bool rent() {
+        int bikes = availableBikes.load(memory_order_relaxed);
+        while (bikes > 0) {
+            if (availableBikes.compare_exchange_weak(bikes, bikes - 1, memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Mengembalikan satu sepeda; false jika semua dok terisi
+    bool returnBike() {
+        int bikes = availableBikes.load(memory_order_relaxed);
+        while (bikes < capacity) {
+            if (availableBikes.compare_exchange_weak(bikes, bikes + 1, memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int getAvailableBikes() const { return availableBikes.load(memory_order_relaxed); }
+    int getFreeDocks() const { return capacity - getAvailableBikes(); }
+    string getStation() const { return station; }
+    double getLatitude() const { return latitude; }
+    double getLongitude() const { return longitude; }
+};
+
+// Hasil pencarian stasiun terdekat
+struct NearbyStation {
+    BikeSharing* station;
+    double distanceMeters;
+};
+
+/**
+ * Indeks grid untuk mencari stasiun sepeda terdekat.
+ *
+ * Lokasi stasiun tidak berubah, jadi grid dibangun sekali: koordinat
+ * diproyeksikan ke meter (equirectangular, cukup akurat dalam satu kota),
+ * stasiun diurutkan per sel, dan setiap sel menyimpan rentang indeks (CSR).
+ * Jumlah sepeda tetap dibaca langsung dari atomic milik BikeSharing, sehingga
+ * sewa/kembali yang berjalan bersamaan tidak perlu lock atau pembaruan indeks.
+ *
+ * Pencarian memeriksa sel berbentuk cincin dari sel titik pencarian ke luar
+ * dan berhenti ketika cincin berikutnya pasti lebih jauh dari hasil ke-n atau
+ * dari radius.
+ */
+class StationIndex {
+private:
+    static constexpr double METERS_PER_DEGREE = 111320.0;
+
+    double cellSize;
+    double referenceCos; // cos(lintang acuan) untuk skala bujur
+    double originX = 0, originY = 0;
+    int cellsX = 0, cellsY = 0;
+    vector<uint32_t> cellStart; // stasiun sel c ada di [cellStart[c], cellStart[c + 1])
+    vector<double> xs, ys;      // posisi stasiun dalam meter, urut per sel
+    vector<BikeSharing*> stations;
+
+    void project(double lat, double lon, double& x, double& y) const {
+        x = lon * METERS_PER_DEGREE * referenceCos;
+        y = lat * METERS_PER_DEGREE;
+    }
+
+    int cellX(double x) const { return (int)floor((x - originX) / cellSize); }
+    int cellY(double y) const { return (int)floor((y - originY) / cellSize); }
+
+public:
+    explicit StationIndex(const vector<BikeSharing*>& all, double cellMeters = 250.0)
+        : cellSize(cellMeters), referenceCos(1.0) {
+        if (all.empty()) {
+            cellStart.assign(1, 0);
+            return;
+        }
+        double latitudeSum = 0;
+        for (const BikeSharing* s : all) {
+            latitudeSum += s->getLatitude();
+        }
+        referenceCos = cos(latitudeSum / all.size() * M_PI / 180.0);
+
+        vector<double> px(all.size()), py(all.size());
+        double maxX = -INFINITY, maxY = -INFINITY;
+        originX = originY = INFINITY;
+        for (size_t i = 0; i < all.size(); i++) {
+            project(all[i]->getLatitude(), all[i]->getLongitude(), px[i], py[i]);
+            originX = min(originX, px[i]);
+            originY = min(originY, py[i]);
+            maxX = max(maxX, px[i]);
+            maxY = max(maxY, py[i]);
+        }
+        cellsX = cellX(maxX) + 1;
+        cellsY = cellY(maxY) + 1;
+
+        // Counting sort stasiun per sel
+        vector<uint32_t> cellOf(all.size());
+        cellStart.assign((size_t)cellsX * cellsY + 1, 0);
+        for (size_t i = 0; i < all.size(); i++) {
+            cellOf[i] = (uint32_t)(cellY(py[i]) * cellsX + cellX(px[i]));
+            cellStart[cellOf[i] + 1]++;
+        }
+        for (size_t c = 1; c < cellStart.size(); c++) {
+            cellStart[c] += cellStart[c - 1];
+        }
+        vector<uint32_t> position(cellStart.begin(), cellStart.end() - 1);
+        xs.resize(all.size());
+        ys.resize(all.size());
+        stations.resize(all.size());
+        for (size_t i = 0; i < all.size(); i++) {
+            uint32_t slot = position[cellOf[i]]++;
+            xs[slot] = px[i];
+            ys[slot] = py[i];
+            stations[slot] = all[i];
+        }
+    }
+
+    /**
+     * @brief Maksimal n stasiun terdekat yang punya sepeda, dalam radius meter
+     *
+     * @param out Minimal n elemen; diisi urut dari yang terdekat
+     * @return Jumlah stasiun yang ditemukan
+     */
+    size_t nearestWithBike(double lat, double lon, double radiusMeters, size_t n, NearbyStation* out) const {
+        if (n == 0 || stations.empty()) {
+            return 0;
+        }
+        double qx, qy;
+        project(lat, lon, qx, qy);
+        int cx = cellX(qx), cy = cellY(qy);
+        double radius2 = radiusMeters * radiusMeters;
+        size_t found = 0; // out[0..found) terurut naik berdasarkan jarak
+
+        int maxRing = (int)ceil(radiusMeters / cellSize) + 1;
+        for (int ring = 0; ring <= maxRing; ring++) {
+            // Titik terdekat cincin ini minimal (ring - 1) sel dari titik pencarian
+            double ringDistance = (ring - 1) * cellSize;
+            if (ring > 0 && (ringDistance > radiusMeters ||
+                             (found == n && ringDistance >= out[n - 1].distanceMeters))) {
+                break;
+            }
+            for (int y = cy - ring; y <= cy + ring; y++) {
+                if (y < 0 || y >= cellsY) {
+                    continue;
+                }
+                bool edgeRow = y == cy - ring || y == cy + ring;
+                int step = edgeRow ? 1 : 2 * ring; // baris tengah: hanya sel kiri dan kanan
+                for (int x = cx - ring; x <= cx + ring; x += step) {
+                    if (x < 0 || x >= cellsX) {
+                        continue;
+                    }
+                    size_t cell = (size_t)y * cellsX + x;
+                    for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                        double dx = xs[i] - qx, dy = ys[i] - qy;
+                        double d2 = dx * dx + dy * dy;
+                        if (d2 > radius2 || (found == n && d2 >= out[n - 1].distanceMeters * out[n - 1].distanceMeters)) {
+                            continue;
+                        }
+                        if (stations[i]->getAvailableBikes() <= 0) {
+                            continue;
+                        }
+                        // Sisipkan terurut (n kecil, insertion sort cukup)
+                        double d = sqrt(d2);
+                        size_t pos = found < n ? found++ : n - 1;
+                        while (pos > 0 && out[pos - 1].distanceMeters > d) {
+                            out[pos] = out[pos - 1];
+                            pos--;
+                        }
+                        out[pos] = {stations[i], d};
+                    }
+                }
+            }
+        }
+        return found;
     }
+
+    size_t size() const { return stations.size(); }
 };
 
+// Benchmark: pencarian stasiun terdekat sambil sewa/kembali berjalan di thread lain
+void benchmarkStationIndex() {
+    const int stationCount = 50000;
+    const int queries = 1000000;
+    const double baseLat = -6.2, baseLon = 106.8; // sekitar Jakarta, area ~30 x 30 km
+    mt19937 rng(17);
+    uniform_real_distribution<double> offset(0.0, 0.27);
+
+    vector<unique_ptr<BikeSharing>> owned;
+    vector<BikeSharing*> all;
+    for (int i = 0; i < stationCount; i++) {
+        int docks = 10 + i % 20;
+        owned.push_back(make_unique<BikeSharing>(i, "Station " + to_string(i), baseLat + offset(rng),
+                                                 baseLon + offset(rng), docks, (int)(rng() % (docks + 1))));
+        all.push_back(owned.back().get());
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    StationIndex index(all);
+    auto t1 = chrono::steady_clock::now();
+
+    atomic<bool> running(true);
+    atomic<long long> updates(0);
+    thread updater([&]() {
+        mt19937 local(23);
+        while (running.load(memory_order_relaxed)) {
+            BikeSharing* s = all[local() % all.size()];
+            if (local() % 2) {
+                s->rent();
+            } else {
+                s->returnBike();
+            }
+            updates.fetch_add(1, memory_order_relaxed);
+        }
+    });
+
+    NearbyStation result[5];
+    size_t totalFound = 0;
+    auto t2 = chrono::steady_clock::now();
+    for (int q = 0; q < queries; q++) {
+        totalFound += index.nearestWithBike(baseLat + offset(rng), baseLon + offset(rng), 500.0, 5, result);
+    }
+    auto t3 = chrono::steady_clock::now();
+    running = false;
+    updater.join();
+
+    cout << "Bangun indeks " << stationCount << " stasiun: " << chrono::duration<double, milli>(t1 - t0).count()
+         << " ms" << endl;
+    cout << "Pencarian 5 terdekat (radius 500 m): " << chrono::duration<double, nano>(t3 - t2).count() / queries
+         << " ns/query, rata-rata " << (double)totalFound / queries << " hasil, " << updates.load()
+         << " update bersamaan" << endl;
+}
+
 // Class Payment untuk integrasi pembayaran
 class Payment {
 private:
@@ -86,6 +335,7 @@ public:
 };
 
 int main() {
+    TRACE_START_EXPORT("transportku_trace.json");
     User user1(101, "Budi", 50000);
     user1.getUserInfo();
 
@@ -100,5 +350,22 @@ int main() {
     Payment payment(user1);
     payment.processPayment(15000);
 
+    // Stasiun dengan koordinat dan jumlah sepeda yang diperbarui atomic
+    BikeSharing monas(402, "Monas", -6.1754, 106.8272, 20, 3);
+    BikeSharing bundaranHI(403, "Bundaran HI", -6.1950, 106.8230, 15, 0);
+    BikeSharing sarinah(404, "Sarinah", -6.1875, 106.8235, 10, 5);
+    StationIndex stations({&monas, &bundaranHI, &sarinah});
+    NearbyStation nearby[2];
+    size_t found = stations.nearestWithBike(-6.1900, 106.8240, 2000.0, 2, nearby);
+    for (size_t i = 0; i < found; i++) {
+        cout << "Stasiun terdekat dengan sepeda: " << nearby[i].station->getStation() << " ("
+             << (int)nearby[i].distanceMeters << " m)" << endl;
+    }
+    sarinah.rent();
+    sarinah.getSchedule();
+
+    benchmarkStationIndex();
+
+    TRACE_STOP_EXPORT(cerr);
     return 0;
 }
@@ -1,7 +1,15 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "instrumentation.h"
 
 // Interface untuk metode pengiriman notifikasi
 class INotificationSender {
@@ -32,7 +40,8 @@ public:
 class EmailNotificationSender : public INotificationSender {
 public:
     void send(const std::string& message) override {
-        std::cout << "Mengirim Email: " << message << std::endl;
+        TRACE_COUNT("notification.sent.email");
+        std::cout << "Mengirim Email: " << message << '\n';
     }
 };
 
@@ -40,7 +49,8 @@ public:
 class SMSNotificationSender : public INotificationSender {
 public:
     void send(const std::string& message) override {
-        std::cout << "Mengirim SMS: " << message << std::endl;
+        TRACE_COUNT("notification.sent.sms");
+        std::cout << "Mengirim SMS: " << message << '\n';
     }
 };
 
@@ -48,7 +58,8 @@ public:
 class PushNotificationSender : public INotificationSender {
 public:
     void send(const std::string& message) override {
-        std::cout << "Mengirim Push Notification: " << message << std::endl;
+        TRACE_COUNT("notification.sent.push");
+        std::cout << "Mengirim Push Notification: " << message << '\n';
     }
 };
 
@@ -85,6 +96,202 @@ public:
     }
 };
 
+// Data penerima untuk kampanye: semua nilai field disimpan di satu string,
+// sehingga jutaan penerima tidak berarti jutaan string kecil. Offset 32-bit
+// menjaga indeks tetap kecil; total data nilai dibatasi MAX_DATA_BYTES.
+class RecipientList {
+private:
+    size_t fieldCount;
+    std::string data;
+    std::vector<uint32_t> offsets; // awal setiap nilai; nilai terakhir berakhir di data.size()
+
+public:
+    static constexpr size_t MAX_DATA_BYTES = UINT32_MAX;
+
+private:
+
+public:
+    explicit RecipientList(size_t fields) : fieldCount(fields) {}
+
+    void reserve(size_t recipients, size_t bytesPerRecipient) {
+        offsets.reserve(recipients * fieldCount);
+        data.reserve(recipients * bytesPerRecipient);
+    }
+
+    // Nilai harus berurutan sesuai daftar field template. Melempar
+    // std::length_error sebelum menambah apa pun jika data melewati MAX_DATA_BYTES.
+    void add(std::initializer_list<std::string_view> values) {
+        if (values.size() != fieldCount) {
+            throw std::invalid_argument("Jumlah nilai penerima tidak sesuai jumlah field");
+        }
+        size_t bytes = 0;
+        for (std::string_view value : values) {
+            bytes += value.size();
+        }
+        if (bytes > MAX_DATA_BYTES - data.size()) {
+            throw std::length_error("Data penerima melebihi batas offset 32-bit");
+        }
+        for (std::string_view value : values) {
+            offsets.push_back((uint32_t)data.size());
+            data.append(value);
+        }
+    }
+
+    size_t size() const { return fieldCount ? offsets.size() / fieldCount : 0; }
+    size_t fields() const { return fieldCount; }
+
+    std::string_view value(size_t recipient, size_t field) const {
+        size_t i = recipient * fieldCount + field;
+        size_t end = i + 1 < offsets.size() ? offsets[i + 1] : data.size();
+        return std::string_view(data).substr(offsets[i], end - offsets[i]);
+    }
+};
+
+/**
+ * Template pesan dengan placeholder {nama_field}, di-parse sekali menjadi
+ * daftar segmen (teks literal atau indeks field). "{{" dan "}}" menghasilkan
+ * kurung kurawal literal.
+ *
+ * Render hanya menyalin segmen ke buffer tujuan; buffer per thread dipakai
+ * ulang sehingga setelah pesan pertama tidak ada alokasi heap lagi.
+ */
+class MessageTemplate {
+private:
+    struct Segment {
+        uint32_t offset; // posisi di literals, atau indeks field jika isField
+        uint32_t length;
+        bool isField;
+    };
+
+    std::string literals;
+    std::vector<Segment> segments;
+    std::vector<std::string> fieldNames;
+
+    template <typename ValueOf>
+    void renderWith(std::string& out, ValueOf valueOf) const {
+        size_t length = literals.size();
+        for (const Segment& segment : segments) {
+            if (segment.isField) {
+                length += valueOf(segment.offset).size();
+            }
+        }
+        out.resize(length); // Tidak mengalokasi jika kapasitas sudah cukup
+        char* p = &out[0];
+        for (const Segment& segment : segments) {
+            if (segment.isField) {
+                std::string_view value = valueOf(segment.offset);
+                value.copy(p, value.size());
+                p += value.size();
+            } else {
+                literals.copy(p, segment.length, segment.offset);
+                p += segment.length;
+            }
+        }
+    }
+
+public:
+    // Melempar std::invalid_argument untuk placeholder tak dikenal atau kurung tidak seimbang
+    MessageTemplate(const std::string& text, const std::vector<std::string>& fields) : fieldNames(fields) {
+        size_t literalStart = literals.size();
+        auto closeLiteral = [&]() {
+            if (literals.size() > literalStart) {
+                segments.push_back({(uint32_t)literalStart, (uint32_t)(literals.size() - literalStart), false});
+            }
+        };
+        for (size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if ((c == '{' || c == '}') && i + 1 < text.size() && text[i + 1] == c) {
+                literals.push_back(c);
+                i++;
+            } else if (c == '{') {
+                size_t close = text.find('}', i);
+                if (close == std::string::npos) {
+                    throw std::invalid_argument("Placeholder tidak ditutup: " + text.substr(i));
+                }
+                std::string name = text.substr(i + 1, close - i - 1);
+                size_t field = 0;
+                while (field < fieldNames.size() && fieldNames[field] != name) {
+                    field++;
+                }
+                if (field == fieldNames.size()) {
+                    throw std::invalid_argument("Field tidak dikenal: " + name);
+                }
+                closeLiteral();
+                segments.push_back({(uint32_t)field, 0, true});
+                literalStart = literals.size();
+                i = close;
+            } else if (c == '}') {
+                throw std::invalid_argument("Kurung tutup tanpa pasangan di posisi " + std::to_string(i));
+            } else {
+                literals.push_back(c);
+            }
+        }
+        closeLiteral();
+    }
+
+    size_t fieldCount() const { return fieldNames.size(); }
+
+    // Melempar std::invalid_argument jika daftar penerima tidak punya tepat satu
+    // nilai untuk setiap field template
+    void checkRecipients(const RecipientList& recipients) const {
+        if (recipients.fields() != fieldNames.size()) {
+            throw std::invalid_argument("Daftar penerima punya " + std::to_string(recipients.fields()) +
+                                        " field, template butuh " + std::to_string(fieldNames.size()));
+        }
+    }
+
+    // Render dengan nilai field sesuai urutan fieldNames
+    void renderInto(std::string& out, const std::string_view* values) const {
+        renderWith(out, [values](uint32_t field) { return values[field]; });
+    }
+
+    void renderInto(std::string& out, const RecipientList& recipients, size_t recipient) const {
+        checkRecipients(recipients);
+        renderWith(out, [&recipients, recipient](uint32_t field) { return recipients.value(recipient, field); });
+    }
+
+    // Render ke buffer milik thread pemanggil; valid sampai render berikutnya di thread yang sama
+    const std::string& render(const RecipientList& recipients, size_t recipient) const {
+        thread_local std::string buffer;
+        renderInto(buffer, recipients, recipient);
+        return buffer;
+    }
+
+    /**
+     * @brief Render pesan untuk seluruh daftar penerima secara paralel
+     *
+     * sink(indeks, pesan) dipanggil dari beberapa thread sekaligus; pesan hanya
+     * valid selama panggilan sink. Penerima dibagi per blok lewat counter atomic.
+     * Jumlah field diperiksa sebelum worker dimulai.
+     */
+    template <typename Sink>
+    void renderAll(const RecipientList& recipients, Sink sink, unsigned threads = 0) const {
+        checkRecipients(recipients);
+        const size_t blockSize = 4096;
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::atomic<size_t> nextBlock(0);
+        auto work = [&]() {
+            size_t begin;
+            while ((begin = nextBlock.fetch_add(blockSize)) < recipients.size()) {
+                size_t end = std::min(recipients.size(), begin + blockSize);
+                for (size_t i = begin; i < end; i++) {
+                    sink(i, render(recipients, i));
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+};
+
 // Kelas untuk mengelola notifikasi
 class NotificationManager {
 private:
@@ -96,14 +303,74 @@ public:
     }
 
     void sendAllNotifications() {
+        TRACE_SCOPE("notification.sendAll");
         for (auto& notification : notifications) {
+            TRACE_SCOPE("notification.send");
             std::cout << "Mengirim Notifikasi " << notification->getType() << ": ";
             notification->send();
         }
     }
+
+    // Kampanye: satu template untuk banyak penerima, tanpa objek Notification per pesan.
+    // Jumlah field diperiksa sebelum pesan pertama dikirim.
+    void sendCampaign(const MessageTemplate& messageTemplate, const RecipientList& recipients,
+                      INotificationSender& sender) {
+        TRACE_SCOPE("notification.sendCampaign");
+        messageTemplate.checkRecipients(recipients);
+        for (size_t i = 0; i < recipients.size(); i++) {
+            sender.send(messageTemplate.render(recipients, i));
+        }
+    }
 };
 
+// Benchmark: penggabungan string per pesan vs template yang sudah dikompilasi
+void benchmarkTemplates() {
+    const size_t count = 2000000;
+    RecipientList recipients(3);
+    recipients.reserve(count, 32);
+    for (size_t i = 0; i < count; i++) {
+        std::string name = "Pelanggan" + std::to_string(i);
+        std::string id = "TRX" + std::to_string(100000 + i);
+        std::string amount = std::to_string(10000 + i % 90000);
+        recipients.add({name, id, amount});
+    }
+    MessageTemplate message("Halo {nama}, transaksi {id} sebesar Rp{jumlah} berhasil diproses. Terima kasih!",
+                            {"nama", "id", "jumlah"});
+
+    size_t bytes[3] = {0, 0, 0};
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        std::string text = "Halo " + std::string(recipients.value(i, 0)) + ", transaksi " +
+                           std::string(recipients.value(i, 1)) + " sebesar Rp" +
+                           std::string(recipients.value(i, 2)) + " berhasil diproses. Terima kasih!";
+        bytes[0] += text.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        bytes[1] += message.render(recipients, i).size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::atomic<size_t> parallelBytes(0);
+    message.renderAll(recipients, [&parallelBytes](size_t, const std::string& text) {
+        parallelBytes.fetch_add(text.size(), std::memory_order_relaxed);
+    });
+    bytes[2] = parallelBytes.load();
+    auto t3 = std::chrono::steady_clock::now();
+
+    auto ns = [count](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / count;
+    };
+    std::cout << "metode,ns_per_pesan" << std::endl;
+    std::cout << "penggabungan string," << ns(t0, t1) << std::endl;
+    std::cout << "template," << ns(t1, t2) << std::endl;
+    std::cout << "template paralel," << ns(t2, t3) << std::endl;
+    if (bytes[0] != bytes[1] || bytes[1] != bytes[2]) {
+        std::cout << "Panjang pesan tidak cocok!" << std::endl;
+    }
+}
+
 int main() {
+    TRACE_START_EXPORT("tugas1_trace.json");
     NotificationManager manager;
 
     // Membuat dan menambahkan berbagai jenis notifikasi
@@ -114,5 +381,25 @@ int main() {
     // Mengirim semua notifikasi
     manager.sendAllNotifications();
 
+    // Kampanye personal lewat template yang di-parse sekali
+    MessageTemplate promo("Halo {nama}, poin Anda {poin}. Tukarkan sebelum {{31 Desember}}!", {"nama", "poin"});
+    RecipientList recipients(2);
+    recipients.add({"Budi", "1200"});
+    recipients.add({"Siti", "450"});
+    EmailNotificationSender email;
+    manager.sendCampaign(promo, recipients, email);
+
+    // Daftar penerima dengan jumlah field berbeda ditolak sebelum ada pesan terkirim
+    RecipientList namesOnly(1);
+    namesOnly.add({"Andi"});
+    try {
+        manager.sendCampaign(promo, namesOnly, email);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Kampanye ditolak: " << e.what() << '\n';
+    }
+
+    benchmarkTemplates();
+
+    TRACE_STOP_EXPORT(std::cerr);
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include "instrumentation.h"
 
 // Interface untuk kemampuan dasar karakter
 class IAbility {
@@ -60,8 +61,10 @@ public:
         : attacker(atk), target(tgt), damage(dmg) {}
 
     void execute() override {
+        TRACE_SCOPE("ability.attack");
+        TRACE_VALUE("ability.attack.damage", damage);
         std::cout << attacker->getName() << " menyerang "
-                  << target->getName() << " dengan damage " << damage << std::endl;
+                  << target->getName() << " dengan damage " << damage << '\n';
         target->takeDamage(damage);
     }
 };
@@ -117,6 +120,7 @@ public:
 
     void executeAbility(size_t index) {
         if (index < abilities.size()) {
+            TRACE_COUNT("ability.executed");
             abilities[index]->execute();
         }
     }
@@ -157,6 +161,8 @@ public:
 };
 
 int main() {
+    TRACE_START_EXPORT("tugas2_trace.json");
+
     // Membuat player
     Player hero("Pahlawan", 100, 5);
 
@@ -189,5 +195,6 @@ int main() {
     std::cout << "Status Health Goblin: " << goblin.getHealth() << std::endl;
     std::cout << "Status Health Hero: " << hero.getHealth() << std::endl;
 
+    TRACE_STOP_EXPORT(std::cerr);
     return 0;
 }